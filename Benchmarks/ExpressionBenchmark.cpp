@@ -0,0 +1,120 @@
+//
+//  ExpressionBenchmark.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+//  Compares the eager vector operators with the lazily evaluated expressions
+//  from VectorExpression.h. Build and run from the repository root:
+//
+//      c++ -std=c++11 -O2 -IMath Benchmarks/ExpressionBenchmark.cpp Math/MathUtility.cpp -o expression_benchmark
+//      ./expression_benchmark
+//
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "Math.h"
+
+static const int count = 4096;
+static const int repetitions = 2000;
+
+template<typename Type, int N>
+std::vector<Vector<Type, N> > random_vectors(std::mt19937& engine) {
+    std::uniform_real_distribution<Type> dist(-1.0f, 1.0f);
+    std::vector<Vector<Type, N> > result(count);
+    for (Vector<Type, N>& v : result) {
+        for (int i = 0; i < N; ++i) {
+            v[i] = dist(engine);
+        }
+    }
+    return result;
+}
+
+// nanoseconds per evaluated expression
+template<typename Function>
+double measure(Function f) {
+    f(); // warm up
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        f();
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ((double)repetitions * count);
+}
+
+template<typename Type, int N>
+Type checksum(const std::vector<Vector<Type, N> >& v) {
+    Type result = 0;
+    for (const Vector<Type, N>& x : v) {
+        result += x[0];
+    }
+    return result;
+}
+
+void report(const char* name, double eager, double lazy) {
+    std::printf("%-28s %10.3f %10.3f %8.2fx\n", name, eager, lazy, eager / lazy);
+}
+
+// p + d * dt * 5, as in GameCore::update_camera
+template<int N>
+void bench_step(const char* name, std::mt19937& engine) {
+    std::vector<Vector<float, N> > p = random_vectors<float, N>(engine);
+    std::vector<Vector<float, N> > d = random_vectors<float, N>(engine);
+    std::vector<Vector<float, N> > out0(count), out1(count);
+    float dt = 0.016f;
+    double eager = measure([&]() {
+        for (int i = 0; i < count; ++i) {
+            out0[i] = p[i] + d[i] * dt * 5.0f;
+        }
+        dt += 1e-9f;
+    });
+    dt = 0.016f;
+    double lazy = measure([&]() {
+        for (int i = 0; i < count; ++i) {
+            out1[i] = ::lazy(p[i]) + ::lazy(d[i]) * dt * 5.0f;
+        }
+        dt += 1e-9f;
+    });
+    if (checksum(out0) != checksum(out1)) {
+        std::printf("%s: results differ\n", name);
+    }
+    report(name, eager, lazy);
+}
+
+// r -= s * (d / l), as in the repulsion of smooth() in GameMap.cpp
+template<int N>
+void bench_accumulate(const char* name, std::mt19937& engine) {
+    std::vector<Vector<float, N> > d = random_vectors<float, N>(engine);
+    std::vector<Vector<float, N> > out0(count), out1(count);
+    double eager = measure([&]() {
+        for (int i = 0; i < count; ++i) {
+            float len = length(d[i]);
+            out0[i] -= 0.01f / len * vector_normal(d[i]);
+        }
+    });
+    double lazy = measure([&]() {
+        for (int i = 0; i < count; ++i) {
+            float len = length(d[i]);
+            out1[i] -= 0.01f / len * (::lazy(d[i]) / (len + 0.000000000001f));
+        }
+    });
+    if (checksum(out0) != checksum(out1)) {
+        std::printf("%s: results differ\n", name);
+    }
+    report(name, eager, lazy);
+}
+
+int main() {
+    std::mt19937 engine(29);
+    std::printf("%-28s %10s %10s %9s\n", "expression (ns/op)", "eager", "lazy", "speedup");
+    bench_step<2>("step Vector2", engine);
+    bench_step<3>("step Vector3", engine);
+    bench_step<4>("step Vector4", engine);
+    bench_step<16>("step Vector<float,16>", engine);
+    bench_accumulate<2>("accumulate Vector2", engine);
+    bench_accumulate<3>("accumulate Vector3", engine);
+    bench_accumulate<16>("accumulate Vector<float,16>", engine);
+    return 0;
+}
@@ -0,0 +1,507 @@
+//
+//  GeometryBenchmark.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+//  Measures how the geometry code in Helper/ scales with the number of
+//  points, from 100 up to 10^6. Build and run from the repository root:
+//
+//      c++ -std=c++11 -O2 -pthread -IMath -IHelper Benchmarks/GeometryBenchmark.cpp Helper/DelaunayTriangulation.cpp Helper/Geometry.cpp Helper/HalfEdgeMesh.cpp Helper/Polygon.cpp Helper/Predicates.cpp Math/Math.cpp Math/MathUtility.cpp Math/Kernels.cpp Math/Transformation3.cpp Math/FastTrigonometry.cpp Math/Random.cpp -o geometry_benchmark
+//      ./geometry_benchmark [--json] [--max-points n]
+//
+//  The point sets are the same for every run, in three kinds: uniform in a
+//  square, clustered around a few centers, and a grid with a little jitter,
+//  which is full of nearly cocircular points. The parallel triangulation uses
+//  one thread per hardware thread.
+//
+//  A wavy outline is triangulated with four holes cut into it, which must
+//  take away their area, and its triangles must cover what is left. Up to
+//  10000 vertices, those of a disc must have the same area as the ear
+//  clipping triangulate() used before, which only finishes convex outlines,
+//  and up to 1000 those of a disc with a hole cut into it as well; otherwise
+//  the benchmark fails. So does a union or
+//  difference of two outlines whose area is not that of the intersection
+//  added or taken away, a hole taken out of the outline that does not take
+//  away its area, or a boolean result with a ring of fewer than 3 points.
+//
+//  The rows of the outlines have the number of vertices asked for; the
+//  benchmark fails if cutting the holes leaves fewer.
+//
+//  Every row has the time, the number and size of the allocations made, and
+//  the peak resident set while it ran, inputs included. Only Linux can reset
+//  the peak between rows; elsewhere it is the peak of the run so far.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include "DelaunayTriangulation.h"
+#include "Polygon.h"
+
+static const unsigned int seed = 29;
+
+// every allocation of the process, counted around each measurement
+static std::atomic<uint64_t> allocation_count(0);
+static std::atomic<uint64_t> allocated_bytes(0);
+
+// not inlined, so that g++ sees operator new paired with operator delete
+// instead of with the free() underneath
+#if defined(__GNUC__)
+#define ALLOCATION_FUNCTION __attribute__((noinline))
+#else
+#define ALLOCATION_FUNCTION
+#endif
+
+ALLOCATION_FUNCTION void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+ALLOCATION_FUNCTION void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+ALLOCATION_FUNCTION void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+ALLOCATION_FUNCTION void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+ALLOCATION_FUNCTION void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+ALLOCATION_FUNCTION void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void reset_peak_rss() {
+#if defined(__linux__)
+    if (FILE* file = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+#endif
+}
+
+// in kilobytes
+long peak_rss() {
+#if defined(__linux__)
+    if (FILE* file = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        long kilobytes = -1;
+        while (std::fgets(line, sizeof(line), file)) {
+            if (std::strncmp(line, "VmHWM:", 6) == 0) {
+                kilobytes = std::atol(line + 6);
+                break;
+            }
+        }
+        std::fclose(file);
+        if (kilobytes >= 0) return kilobytes;
+    }
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+struct Result {
+    std::string name;
+    std::string input;
+    int points;
+    double ms;
+    uint64_t allocations;
+    uint64_t bytes;
+    long peak_rss_kb;
+};
+
+static std::vector<Result> results;
+static bool failed = false;
+
+// runs work once and records it as a row
+template<typename Work>
+void measure(const char* name, const char* input, int points, Work work) {
+    reset_peak_rss();
+    uint64_t allocations = allocation_count.load();
+    uint64_t bytes = allocated_bytes.load();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    work();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    results.push_back(Result{name, input, points, std::chrono::duration<double, std::milli>(end - start).count(),
+                             allocation_count.load() - allocations, allocated_bytes.load() - bytes, peak_rss()});
+}
+
+typedef enum {
+    InputUniform,
+    InputClustered,
+    InputGrid
+} InputDistribution;
+
+const char* input_name(InputDistribution distribution) {
+    switch (distribution) {
+        case InputUniform: return "uniform";
+        case InputClustered: return "clustered";
+        case InputGrid: return "grid";
+    }
+    return "";
+}
+
+// count points in [-100, 100]^2
+std::vector<Point2*> random_points(int count, InputDistribution distribution, Arena<Point2>& arena) {
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::vector<Point2*> points(count);
+    if (distribution == InputClustered) {
+        // normal around 16 centers, which the points pick at random
+        std::vector<Vector2> centers;
+        for (int i = 0; i < 16; ++i) {
+            float x = 0.8f * dist(engine);
+            float y = 0.8f * dist(engine);
+            centers.push_back(Vector2(x, y));
+        }
+        std::normal_distribution<float> spread(0.0f, 4.0f);
+        for (int i = 0; i < count; ++i) {
+            Vector2 const& center = centers[engine() % centers.size()];
+            float x = std::max(-100.0f, std::min(100.0f, center[0] + spread(engine)));
+            float y = std::max(-100.0f, std::min(100.0f, center[1] + spread(engine)));
+            points[i] = arena.create(Vector2(x, y));
+        }
+    } else if (distribution == InputGrid) {
+        // row by row, moved by a thousandth of the spacing at most
+        int side = (int)std::ceil(std::sqrt((double)count));
+        float spacing = 200.0f / side;
+        std::uniform_real_distribution<float> jitter(-0.001f * spacing, 0.001f * spacing);
+        for (int i = 0; i < count; ++i) {
+            float x = -100.0f + spacing * (i % side + 0.5f) + jitter(engine);
+            float y = -100.0f + spacing * (i / side + 0.5f) + jitter(engine);
+            points[i] = arena.create(Vector2(x, y));
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            float x = dist(engine);
+            float y = dist(engine);
+            points[i] = arena.create(Vector2(x, y));
+        }
+    }
+    return points;
+}
+
+void bench_delaunay(const char* name, int count, InputDistribution distribution, InsertionOrder order, int threads = 1) {
+    Arena<Point2> arena;
+    std::vector<Point2*> points = random_points(count, distribution, arena);
+    measure(name, input_name(distribution), count, [&]() {
+        DelaunayTriangulation triangulation(points, order, threads);
+    });
+}
+
+void bench_convex_hull(const char* name, int count, InputDistribution distribution, int threads = 1) {
+    Arena<Point2> arena;
+    std::vector<Point2*> points = random_points(count, distribution, arena);
+    measure(name, input_name(distribution), count, [&]() {
+        std::vector<Point2*> hull = convex_hull(points, threads);
+    });
+}
+
+void bench_adjacency(const char* name, int count, InputDistribution distribution) {
+    Arena<Point2> arena;
+    std::vector<Point2*> points = random_points(count, distribution, arena);
+    DelaunayTriangulation triangulation(points, InsertBRIO);
+    measure(name, input_name(distribution), count, [&]() {
+        SiteAdjacency adjacency = triangulation.adjacency();
+    });
+}
+
+void bench_voronoi_polygons(const char* name, int count, InputDistribution distribution) {
+    Arena<Point2> arena;
+    std::vector<Point2*> points = random_points(count, distribution, arena);
+    DelaunayTriangulation triangulation(points, InsertBRIO);
+    measure(name, input_name(distribution), count, [&]() {
+        VoronoiPolygons polygons = triangulation.voronoi_polygons(Vector2(-100.0f, -100.0f), Vector2(100.0f, 100.0f));
+    });
+}
+
+// the diagram the map is generated from, and the mesh of every cell by
+// voronoi_cell_mesh(), which clips the map rectangle by each neighbour
+void bench_voronoi_diagram(int count, InputDistribution distribution) {
+    Arena<Point2> arena;
+    std::vector<Point2*> points = random_points(count, distribution, arena);
+    measure("voronoi diagram", input_name(distribution), count, [&]() {
+        VoronoiDiagram diagram(200.0f, 200.0f, points);
+    });
+    VoronoiDiagram diagram(200.0f, 200.0f, points);
+    measure("voronoi cell meshes", input_name(distribution), count, [&]() {
+        for (VoronoiCell2* cell : diagram.cells()) {
+            std::vector<Vector3> mesh = voronoi_cell_mesh(200.0f, 200.0f, cell);
+        }
+    });
+}
+
+// inserts edit_count new random points and removes as many sites, which
+// only repairs the mesh around them, instead of triangulating count points again
+void bench_site_edits(const char* name, int count, InputDistribution distribution) {
+    static const int edit_count = 1000;
+    Arena<Point2> arena;
+    std::vector<Point2*> points = random_points(count, distribution, arena);
+    std::vector<Point2*> inserted = random_points(edit_count, InputUniform, arena);
+    DelaunayTriangulation triangulation(points, InsertBRIO);
+    std::mt19937 engine(seed);
+    std::vector<uint32_t> changed;
+    measure(name, input_name(distribution), count, [&]() {
+        for (int i = 0; i < edit_count; ++i) {
+            triangulation.insert_site(inserted[i], changed);
+            triangulation.remove_site(engine() % count, changed);
+        }
+    });
+}
+
+// triangulate() before triangulate_polygon: restarts the search after every
+// ear and tests the diagonal against all edges. Gives up with no triangles
+// where it would have looked for an ear forever.
+std::vector<Vector2> reference_triangulate(std::vector<Vector2> const& points) {
+    std::vector<Vector2> triangulation;
+    std::vector<Vector2> remaining = points;
+    while (remaining.size() > 3) {
+        size_t size = remaining.size();
+        for (size_t i0 = 0; i0 < remaining.size(); ++i0) {
+            size_t i1 = i0+1 < remaining.size() ? i0+1 : 0;
+            size_t i2 = i1+1 < remaining.size() ? i1+1 : 0;
+            if (area(remaining[i0], remaining[i1], remaining[i2]) > 0.0f) {
+                bool valid = true;
+                for (size_t j0 = 0; j0 < remaining.size(); ++j0) {
+                    size_t j1 = j0+1 < remaining.size() ? j0+1 : 0;
+                    Vector2 tmp;
+                    if (segment_intersection(remaining[i0], remaining[i2],
+                                             remaining[j0], remaining[j1], tmp)) {
+                        valid = false;
+                        break;
+                    }
+                }
+                if (valid) {
+                    triangulation.push_back(remaining[i0]);
+                    triangulation.push_back(remaining[i1]);
+                    triangulation.push_back(remaining[i2]);
+                    remaining.erase(remaining.begin()+i1);
+                    break;
+                }
+            }
+        }
+        if (remaining.size() == size) return std::vector<Vector2>();
+    }
+    triangulation.insert(triangulation.end(), remaining.begin(), remaining.end());
+    return triangulation;
+}
+
+double polygon_area(std::vector<Vector2> const& polygon) {
+    double sum = 0.0;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        sum += 0.5 * ((double)polygon[j][0] * polygon[i][1] - (double)polygon[i][0] * polygon[j][1]);
+    }
+    return sum;
+}
+
+double triangles_area(std::vector<Vector2> const& corners) {
+    double sum = 0.0;
+    for (size_t i = 0; i + 2 < corners.size(); i += 3) {
+        sum += 0.5 * orient2d(corners[i], corners[i + 1], corners[i + 2]);
+    }
+    return sum;
+}
+
+void check_area(const char* name, double area, double expected) {
+    if (!(std::fabs(area - expected) <= 1e-5 * std::fabs(expected))) {
+        std::fprintf(stderr, "%s: area %f instead of %f\n", name, area, expected);
+        failed = true;
+    }
+}
+
+// a procedurally generated outline with count vertices, or a disc, with holes
+// cut into it like the shapes in GameShapes.cpp. The benchmark fails if the
+// holes do not take away their area or the outline loses vertices.
+std::vector<Vector2> outline(int count, bool wavy, int holes = 4) {
+    std::vector<Vector2> shape;
+    for (int i = 0; i < count; ++i) {
+        float t = 2.0f * PI * i / count;
+        float r = 70.0f;
+        if (wavy) {
+            r += 15.0f * sinf(7.0f * t) + 7.0f * sinf(23.0f * t + 1.0f) + 3.0f * sinf(97.0f * t);
+        }
+        shape.push_back(Vector2(r * cosf(t), r * sinf(t)));
+    }
+    double area = polygon_area(shape);
+    for (int i = 0; i < holes; ++i) {
+        float a = 0.5f * PI * (i + 0.5f);
+        std::vector<Vector2> hole = circle(Vector2(20.0f * cosf(a), 20.0f * sinf(a)), 8.0f, 16);
+        area -= polygon_area(hole);
+        shape = cut(shape, hole);
+    }
+    check_area("outline", polygon_area(shape), area);
+    if ((int)shape.size() < count) {
+        std::fprintf(stderr, "outline: %zu vertices instead of at least %d\n", shape.size(), count);
+        failed = true;
+    }
+    return shape;
+}
+
+std::vector<Vector2> bench_triangulate(const char* name, const char* input, int points, std::vector<Vector2> const& shape,
+                                       std::vector<Vector2> (*triangulate)(std::vector<Vector2> const&)) {
+    std::vector<Vector2> triangles;
+    measure(name, input, points, [&]() {
+        triangles = triangulate(shape);
+    });
+    return triangles;
+}
+
+void bench_polygon_triangulation(int count) {
+    std::vector<Vector2> shape = outline(count, true);
+    check_area("triangulate", triangles_area(bench_triangulate("triangulate", "outline", count, shape, triangulate)), polygon_area(shape));
+    if (count > 10000) return;
+    // the old ear clipping is quadratic in the best case
+    // the old code gives up on the 10000 vertex disc with a hole, whose
+    // rounded corners leave a vertex that is reflex by a hair
+    for (int holes = 0; holes <= (count <= 1000 ? 1 : 0); ++holes) {
+        const char* input = holes ? "disc, hole" : "disc";
+        shape = outline(count, false, holes);
+        double area = triangles_area(bench_triangulate("triangulate", input, count, shape, triangulate));
+        check_area("triangulate disc", area, triangles_area(bench_triangulate("ear clipping (old)", input, count, shape, reference_triangulate)));
+    }
+}
+
+double rings_area(std::vector<std::vector<Vector2>> const& rings) {
+    double sum = 0.0;
+    for (std::vector<Vector2> const& ring : rings) {
+        sum += polygon_area(ring);
+    }
+    return sum;
+}
+
+double bench_boolean(const char* name, int points, std::vector<Vector2> const& a, std::vector<Vector2> const& b, PolygonOperation operation) {
+    std::vector<std::vector<Vector2>> rings;
+    measure(name, "outline", points, [&]() {
+        rings = polygon_boolean({a}, {b}, operation);
+    });
+    size_t degenerate = 0;
+    for (std::vector<Vector2> const& ring : rings) {
+        degenerate += ring.size() < 3;
+    }
+    if (degenerate > 0) {
+        std::fprintf(stderr, "%s: %zu rings of fewer than 3 points\n", name, degenerate);
+        failed = true;
+    }
+    return rings_area(rings);
+}
+
+void bench_polygon_booleans(int count) {
+    // a hole in the outline without holes, whose neighbouring edges are
+    // nearly collinear when it is dense
+    std::vector<Vector2> ring = outline(count, true, 0);
+    std::vector<Vector2> hole = circle(Vector2(0.0f, 0.0f), 8.0f, 16);
+    check_area("polygon hole", bench_boolean("polygon hole", count, ring, hole, PolygonDifference), polygon_area(ring) - polygon_area(hole));
+
+    // the outline and the same turned and moved, with their holes
+    std::vector<Vector2> a = outline(count, true);
+    std::vector<Vector2> b;
+    for (Vector2 const& p : a) {
+        b.push_back(Vector2(0.8f * p[0] - 0.6f * p[1] + 15.0f, 0.6f * p[0] + 0.8f * p[1] + 5.0f));
+    }
+    double intersection = bench_boolean("polygon intersection", 2 * count, a, b, PolygonIntersection);
+    check_area("polygon union", bench_boolean("polygon union", 2 * count, a, b, PolygonUnion), polygon_area(a) + polygon_area(b) - intersection);
+    check_area("polygon difference", bench_boolean("polygon difference", 2 * count, a, b, PolygonDifference), polygon_area(a) - intersection);
+
+    // a bite out of the edge of the outline
+    std::vector<Vector2> bite = circle(Vector2(70.0f, 0.0f), 30.0f, 64);
+    std::vector<Vector2> shape;
+    measure("cut", "outline", count, [&]() {
+        shape = cut(a, bite);
+    });
+    // cut() keeps the largest of the pieces the bite may split off
+    double largest = 0.0;
+    for (std::vector<Vector2> const& piece : join_holes(polygon_boolean({a}, {bite}, PolygonDifference))) {
+        largest = std::max(largest, polygon_area(piece));
+    }
+    check_area("cut", polygon_area(shape), largest);
+}
+
+void print_table() {
+    std::printf("seed: %u\n", seed);
+    std::printf("%-32s %-10s %10s %12s %12s %12s %14s\n", "operation", "input", "points", "ms", "ns/point", "allocations", "peak RSS MB");
+    for (const Result& r : results) {
+        std::printf("%-32s %-10s %10d %12.2f %12.1f %12llu %14.1f\n", r.name.c_str(), r.input.c_str(), r.points, r.ms,
+                    r.ms * 1e6 / r.points, (unsigned long long)r.allocations, r.peak_rss_kb / 1024.0);
+    }
+}
+
+void print_json() {
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"geometry\",\n");
+    std::printf("  \"seed\": %u,\n", seed);
+    std::printf("  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        Result const& r = results[i];
+        std::printf("    {\"name\": \"%s\", \"input\": \"%s\", \"points\": %d, \"ms\": %.3f, \"ns_per_point\": %.2f, "
+                    "\"allocations\": %llu, \"allocated_bytes\": %llu, \"peak_rss_kb\": %ld}%s\n",
+                    r.name.c_str(), r.input.c_str(), r.points, r.ms, r.ms * 1e6 / r.points,
+                    (unsigned long long)r.allocations, (unsigned long long)r.bytes, r.peak_rss_kb,
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n");
+    std::printf("}\n");
+}
+
+int main(int argc, const char* argv[]) {
+    bool json = false;
+    int max_points = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strcmp(argv[i], "--max-points") == 0 && i + 1 < argc) {
+            max_points = std::atoi(argv[++i]);
+        }
+    }
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int count = 100; count <= max_points; count *= 10) {
+        for (InputDistribution distribution : {InputUniform, InputClustered, InputGrid}) {
+            bench_delaunay("delaunay brio", count, distribution, InsertBRIO);
+            bench_delaunay("delaunay brio parallel", count, distribution, InsertBRIO, threads);
+            bench_convex_hull("convex hull", count, distribution);
+            bench_convex_hull("convex hull parallel", count, distribution, threads);
+            bench_adjacency("site adjacency", count, distribution);
+            bench_voronoi_polygons("voronoi polygons", count, distribution);
+            bench_site_edits("1000 site inserts and removals", count, distribution);
+            bench_voronoi_diagram(count, distribution);
+            // the walk from the last face crosses O(sqrt(n)) faces per point
+            // on unordered input, so this stops early
+            if (count <= 100000) {
+                bench_delaunay("delaunay in order", count, distribution, InsertInOrder);
+            }
+        }
+        bench_polygon_triangulation(count);
+        bench_polygon_booleans(count);
+    }
+    if (json) {
+        print_json();
+    } else {
+        print_table();
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,300 @@
+//
+//  MathBenchmark.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+//  Measures the cost of the operations in Math/ on fixed-seed inputs. Build
+//  and run from the repository root:
+//
+//      c++ -std=c++11 -O2 -IMath Benchmarks/MathBenchmark.cpp Math/Math.cpp Math/MathUtility.cpp Math/Kernels.cpp Math/Transformation3.cpp Math/FastTrigonometry.cpp Math/QuaternionBatch.cpp Math/Random.cpp -o math_benchmark
+//      ./math_benchmark [--json]
+//
+//  Prints a table by default and a JSON document with --json, so runs before
+//  and after a change can be compared by a script.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "Math.h"
+#include "Kernels.h"
+#include "QuaternionBatch.h"
+#include "Transformation3.h"
+
+static const unsigned int seed = 29;
+static const int count = 1024;
+static const int repetitions = 2000;
+
+struct Result {
+    std::string name;
+    double ns_per_op;
+};
+
+static std::vector<Result> results;
+
+// keeps the compiler from dropping the benchmarked work
+static volatile float sink;
+
+// Runs out[i] = f(i) for every input index, repetitions times. Storing the
+// whole result keeps the compiler from computing only part of it.
+template<typename T, typename Function>
+void measure(const char* name, std::vector<T>& out, Function f) {
+    out.resize(count);
+    for (int i = 0; i < count; ++i) {
+        out[i] = f(i); // warm up
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (int i = 0; i < count; ++i) {
+            out[i] = f(i);
+        }
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    float first;
+    std::memcpy(&first, &out[count - 1], sizeof(float));
+    sink = first;
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    results.push_back(Result{name, ns / ((double)repetitions * count)});
+}
+
+struct Inputs {
+    std::vector<float> s;
+    std::vector<Vector<float, 2> > v2[2];
+    std::vector<Vector<float, 3> > v3[2];
+    std::vector<Vector<float, 4> > v4[2];
+    std::vector<Matrix<float, 3, 3> > m3[2];
+    std::vector<Matrix<float, 4, 4> > m4[2];
+    std::vector<Quaternion<float> > q[2];
+
+    explicit Inputs(std::mt19937& engine) {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        s.resize(count);
+        for (int k = 0; k < 2; ++k) {
+            v2[k].resize(count);
+            v3[k].resize(count);
+            v4[k].resize(count);
+            m3[k].resize(count);
+            m4[k].resize(count);
+            q[k].resize(count);
+        }
+        for (int i = 0; i < count; ++i) {
+            s[i] = dist(engine) + 2.0f;
+            for (int k = 0; k < 2; ++k) {
+                // one component at a time: the order in which the arguments
+                // of a constructor are evaluated differs between compilers
+                for (int j = 0; j < 2; ++j) {
+                    v2[k][i][j] = dist(engine);
+                }
+                for (int j = 0; j < 3; ++j) {
+                    v3[k][i][j] = dist(engine);
+                }
+                for (int j = 0; j < 4; ++j) {
+                    v4[k][i][j] = dist(engine);
+                }
+                for (int j = 0; j < 9; ++j) {
+                    m3[k][i].data[j] = dist(engine);
+                }
+                for (int j = 0; j < 16; ++j) {
+                    m4[k][i].data[j] = dist(engine);
+                }
+                float w = dist(engine);
+                float x = dist(engine);
+                float y = dist(engine);
+                float z = dist(engine);
+                q[k][i] = quaternion_normal(Quaternion<float>(w, x, y, z));
+            }
+        }
+    }
+};
+
+void bench_vectors(const Inputs& in) {
+    std::vector<float> f;
+    std::vector<Vector<float, 2> > v2;
+    std::vector<Vector<float, 3> > v3;
+    std::vector<Vector<float, 4> > v4;
+
+    measure("vector2 add", v2, [&](int i) { return in.v2[0][i] + in.v2[1][i]; });
+    measure("vector2 scale", v2, [&](int i) { return in.v2[0][i] * in.s[i]; });
+    measure("vector2 dot", f, [&](int i) { return dot(in.v2[0][i], in.v2[1][i]); });
+    measure("vector2 normalize", v2, [&](int i) { return vector_normal(in.v2[0][i]); });
+
+    measure("vector3 add", v3, [&](int i) { return in.v3[0][i] + in.v3[1][i]; });
+    measure("vector3 scale", v3, [&](int i) { return in.v3[0][i] * in.s[i]; });
+    measure("vector3 dot", f, [&](int i) { return dot(in.v3[0][i], in.v3[1][i]); });
+    measure("vector3 cross", v3, [&](int i) { return cross(in.v3[0][i], in.v3[1][i]); });
+    measure("vector3 normalize", v3, [&](int i) { return vector_normal(in.v3[0][i]); });
+
+    measure("vector4 add", v4, [&](int i) { return in.v4[0][i] + in.v4[1][i]; });
+    measure("vector4 scale", v4, [&](int i) { return in.v4[0][i] * in.s[i]; });
+    measure("vector4 dot", f, [&](int i) { return dot(in.v4[0][i], in.v4[1][i]); });
+    measure("vector4 normalize", v4, [&](int i) { return vector_normal(in.v4[0][i]); });
+}
+
+void bench_matrices(const Inputs& in) {
+    std::vector<float> f;
+    std::vector<Vector<float, 4> > v4;
+    std::vector<Matrix<float, 3, 3> > m3;
+    std::vector<Matrix<float, 4, 4> > m4;
+
+    measure("matrix3 multiply", m3, [&](int i) { return in.m3[0][i] * in.m3[1][i]; });
+    measure("matrix3 det", f, [&](int i) { return det(in.m3[0][i]); });
+    measure("matrix3 inverse", m3, [&](int i) { return inverse(in.m3[0][i]); });
+
+    measure("matrix4 multiply", m4, [&](int i) { return in.m4[0][i] * in.m4[1][i]; });
+    measure("matrix4 transform", v4, [&](int i) { return in.m4[0][i] * in.v4[0][i]; });
+    measure("matrix4 det", f, [&](int i) { return det(in.m4[0][i]); });
+    measure("matrix4 inverse", m4, [&](int i) { return inverse(in.m4[0][i]); });
+    measure("matrix4 affine_inverse", m4, [&](int i) { return affine_inverse(in.m4[0][i]); });
+    measure("matrix4 rigid_inverse", m4, [&](int i) { return rigid_inverse(in.m4[0][i]); });
+
+    // per vector, the whole block is transformed at index 0
+    std::vector<Vector<float, 4> > block(count);
+    measure("batch_transform (per vector)", f, [&](int i) {
+        if (i == 0) {
+            batch_transform(in.m4[0][0], &in.v4[0][0], &block[0], count);
+        }
+        return block[i][0];
+    });
+}
+
+void bench_quaternions(const Inputs& in) {
+    std::vector<Vector<float, 3> > v3;
+    std::vector<Matrix<float, 4, 4> > m4;
+    std::vector<Quaternion<float> > q;
+
+    measure("quaternion multiply", q, [&](int i) { return in.q[0][i] * in.q[1][i]; });
+    measure("quaternion rotate", v3, [&](int i) { return rotate(in.q[0][i], in.v3[0][i]); });
+    measure("quaternion normalize", q, [&](int i) { return quaternion_normal(in.q[0][i]); });
+    measure("quaternion to matrix4", m4, [&](int i) { return homogeneous_rotation(in.q[0][i]); });
+    measure("quaternion slerp", q, [&](int i) { return spherical_linear_interpolation(in.q[0][i], in.q[1][i], 0.3f); });
+}
+
+// the structure of arrays kernels, per quaternion; the whole block is
+// processed at index 0
+void bench_quaternion_batches(const Inputs& in) {
+    std::vector<float> f;
+    std::vector<float> soa[2][4];
+    std::vector<float> out[4];
+    std::vector<float> v[3];
+    std::vector<float> t(count, 0.3f);
+    for (int c = 0; c < 4; ++c) {
+        for (int k = 0; k < 2; ++k) {
+            soa[k][c].resize(count);
+            for (int i = 0; i < count; ++i) {
+                soa[k][c][i] = in.q[k][i][c];
+            }
+        }
+        out[c].resize(count);
+    }
+    for (int c = 0; c < 3; ++c) {
+        v[c].resize(count);
+        for (int i = 0; i < count; ++i) {
+            v[c][i] = in.v3[0][i][c];
+        }
+    }
+    QuaternionArrays q0 = {&soa[0][0][0], &soa[0][1][0], &soa[0][2][0], &soa[0][3][0]};
+    QuaternionArrays q1 = {&soa[1][0][0], &soa[1][1][0], &soa[1][2][0], &soa[1][3][0]};
+    QuaternionArrays result = {&out[0][0], &out[1][0], &out[2][0], &out[3][0]};
+    Vector3Arrays vectors = {&v[0][0], &v[1][0], &v[2][0]};
+    Vector3Arrays rotated = {&out[0][0], &out[1][0], &out[2][0]};
+    
+    measure("batch quaternion multiply", f, [&](int i) {
+        if (i == 0) {
+            batch_quaternion_multiply(q0, q1, result, count);
+        }
+        return out[0][i];
+    });
+    measure("batch quaternion rotate", f, [&](int i) {
+        if (i == 0) {
+            batch_rotate(q0, vectors, rotated, count);
+        }
+        return out[0][i];
+    });
+    measure("batch quaternion normalize", f, [&](int i) {
+        if (i == 0) {
+            batch_quaternion_normal(q0, result, count);
+        }
+        return out[0][i];
+    });
+    measure("batch quaternion from axis angle", f, [&](int i) {
+        if (i == 0) {
+            batch_quaternion_from_axis_angle(vectors, &in.s[0], result, count);
+        }
+        return out[0][i];
+    });
+    measure("batch quaternion nlerp", f, [&](int i) {
+        if (i == 0) {
+            batch_nlerp(q0, q1, &t[0], result, count);
+        }
+        return out[0][i];
+    });
+    measure("batch quaternion slerp", f, [&](int i) {
+        if (i == 0) {
+            batch_slerp(q0, q1, &t[0], result, count);
+        }
+        return out[0][i];
+    });
+}
+
+void bench_transformations(const Inputs& in) {
+    std::vector<Matrix<float, 4, 4> > m4;
+    Transformation3 transformation;
+    measure("transformation3 rotate + local_to_world", m4, [&](int i) {
+        transformation.set_rotation(in.q[0][i]);
+        return transformation.local_to_world();
+    });
+    measure("transformation3 rotate + world_to_local", m4, [&](int i) {
+        transformation.set_rotation(in.q[0][i]);
+        return transformation.world_to_local();
+    });
+    measure("transformation3 translate + world_to_local", m4, [&](int i) {
+        transformation.set_translation(in.v3[0][i]);
+        return transformation.world_to_local();
+    });
+}
+
+void print_table() {
+    std::printf("kernel set: %s, seed: %u\n", kernel_set_name(active_kernel_set()), seed);
+    std::printf("%-44s %10s %12s\n", "operation", "ns/op", "Mops/s");
+    for (const Result& r : results) {
+        std::printf("%-44s %10.3f %12.1f\n", r.name.c_str(), r.ns_per_op, 1000.0 / r.ns_per_op);
+    }
+}
+
+void print_json() {
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"math\",\n");
+    std::printf("  \"kernel_set\": \"%s\",\n", kernel_set_name(active_kernel_set()));
+    std::printf("  \"seed\": %u,\n", seed);
+    std::printf("  \"count\": %d,\n", count);
+    std::printf("  \"repetitions\": %d,\n", repetitions);
+    std::printf("  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::printf("    {\"name\": \"%s\", \"ns_per_op\": %.4f, \"mops_per_s\": %.2f}%s\n",
+                    results[i].name.c_str(), results[i].ns_per_op, 1000.0 / results[i].ns_per_op,
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n");
+    std::printf("}\n");
+}
+
+int main(int argc, const char* argv[]) {
+    bool json = argc > 1 && std::strcmp(argv[1], "--json") == 0;
+    std::mt19937 engine(seed);
+    Inputs inputs(engine);
+    bench_vectors(inputs);
+    bench_matrices(inputs);
+    bench_quaternions(inputs);
+    bench_quaternion_batches(inputs);
+    bench_transformations(inputs);
+    if (json) {
+        print_json();
+    } else {
+        print_table();
+    }
+    return 0;
+}
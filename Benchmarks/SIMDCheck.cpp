@@ -0,0 +1,164 @@
+//
+//  SIMDCheck.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+//  Checks that the SSE kernels in SIMD.h give the same bits as their scalar
+//  fallback. Build it once with the kernels and once with MATH_NO_SIMD, run
+//  both from the repository root and compare what they print:
+//
+//      c++ -std=c++11 -O2 -IMath Benchmarks/SIMDCheck.cpp Math/MathUtility.cpp -o simd_check
+//      c++ -std=c++11 -O2 -IMath -DMATH_NO_SIMD Benchmarks/SIMDCheck.cpp Math/MathUtility.cpp -o simd_check_scalar
+//      ./simd_check > simd.txt && ./simd_check_scalar > scalar.txt && diff simd.txt scalar.txt
+//
+//  Every line is an operation and a hash of the bits of all its results, so
+//  diff names the operations whose paths differ. The inputs are the same for
+//  every run: random values of all magnitudes, signed zeros, subnormals and
+//  values whose products overflow. Flags that let the compiler contract or
+//  reorder the scalar code, like -ffast-math or -mfma, break the guarantee.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Math.h"
+
+static const unsigned int seed = 29;
+static const int count = 4096;
+
+// FNV-1a over the bits of the results
+class Hash {
+    uint64_t _value;
+
+public:
+    Hash() : _value(14695981039346656037ull) {}
+
+    void add(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        for (int i = 0; i < 4; ++i) {
+            _value = (_value ^ ((bits >> (8 * i)) & 0xff)) * 1099511628211ull;
+        }
+    }
+
+    template<int N>
+    void add(Vector<float, N> const& v) {
+        for (int i = 0; i < N; ++i) {
+            add(v[i]);
+        }
+    }
+
+    void add(Matrix<float, 4, 4> const& m) {
+        for (int i = 0; i < 16; ++i) {
+            add(m.data[i]);
+        }
+    }
+
+    uint64_t value() const { return _value; }
+};
+
+float random_float(std::mt19937& engine) {
+    static const float special[] = {0.0f, -0.0f, 1e-40f, -1e-42f, 1e30f, -1e30f, 1.0f, -1.0f};
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    if (engine() % 16 == 0) {
+        return special[engine() % 8];
+    }
+    return std::ldexp(dist(engine), exponent(engine));
+}
+
+template<typename Operation>
+void check(const char* name, Operation operation) {
+    std::mt19937 engine(seed);
+    Hash hash;
+    for (int i = 0; i < count; ++i) {
+        operation(engine, hash);
+    }
+    std::printf("%-24s %016llx\n", name, (unsigned long long)hash.value());
+}
+
+Vector<float, 4> random_vector(std::mt19937& engine) {
+    Vector<float, 4> v;
+    for (int i = 0; i < 4; ++i) {
+        v[i] = random_float(engine);
+    }
+    return v;
+}
+
+Matrix<float, 4, 4> random_matrix(std::mt19937& engine) {
+    Matrix<float, 4, 4> m;
+    for (int i = 0; i < 16; ++i) {
+        m.data[i] = random_float(engine);
+    }
+    return m;
+}
+
+int main() {
+#if defined(MATH_SIMD_AVX)
+    std::fprintf(stderr, "kernels: sse avx\n");
+#elif defined(MATH_SIMD_SSE)
+    std::fprintf(stderr, "kernels: sse\n");
+#else
+    std::fprintf(stderr, "kernels: scalar\n");
+#endif
+    check("vector + vector", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine), b = random_vector(engine);
+        hash.add(a + b);
+    });
+    check("vector + scalar", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine);
+        float s = random_float(engine);
+        hash.add(a + s);
+        hash.add(s + a);
+    });
+    check("vector - vector", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine), b = random_vector(engine);
+        hash.add(a - b);
+    });
+    check("vector - scalar", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine);
+        float s = random_float(engine);
+        hash.add(a - s);
+    });
+    check("-vector", [](std::mt19937& engine, Hash& hash) {
+        hash.add(-random_vector(engine));
+    });
+    check("vector * vector", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine), b = random_vector(engine);
+        hash.add(a * b);
+    });
+    check("vector * scalar", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine);
+        float s = random_float(engine);
+        hash.add(a * s);
+        hash.add(s * a);
+    });
+    check("vector / vector", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine), b = random_vector(engine);
+        hash.add(a / b);
+    });
+    check("vector / scalar", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine);
+        float s = random_float(engine);
+        hash.add(a / s);
+    });
+    check("dot", [](std::mt19937& engine, Hash& hash) {
+        Vector<float, 4> a = random_vector(engine), b = random_vector(engine);
+        hash.add(dot(a, b));
+    });
+    check("matrix * vector", [](std::mt19937& engine, Hash& hash) {
+        Matrix<float, 4, 4> a = random_matrix(engine);
+        hash.add(a * random_vector(engine));
+    });
+    check("matrix * matrix", [](std::mt19937& engine, Hash& hash) {
+        Matrix<float, 4, 4> a = random_matrix(engine), b = random_matrix(engine);
+        hash.add(a * b);
+    });
+    check("transpose", [](std::mt19937& engine, Hash& hash) {
+        hash.add(transpose(random_matrix(engine)));
+    });
+    return 0;
+}
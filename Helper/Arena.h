@@ -0,0 +1,73 @@
+//
+//  Arena.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __LD29__Arena__
+#define __LD29__Arena__
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Owns objects of one type in blocks of block_size, for structures that
+ * allocate many small objects and release them together, like the faces of a
+ * triangulation. Objects created one after another are next to each other in
+ * memory. destroy() hands an object's memory to the next create(); all memory
+ * is released at once by clear() or the destructor, without running any
+ * destructors, so Type has to be trivially destructible.
+ */
+template<typename Type>
+class Arena {
+    static_assert(std::is_trivially_destructible<Type>::value, "the arena releases objects without destroying them");
+
+    static const int block_size = 1024;
+
+    std::vector<Type*> _blocks;
+    int _used; // objects taken from the last block
+    std::vector<Type*> _free;
+
+    Arena(Arena const&) = delete;
+    Arena const& operator = (Arena const&) = delete;
+
+public:
+    Arena() : _used(block_size) {}
+    ~Arena() {
+        clear();
+    }
+
+    template<typename... Args>
+    Type* create(Args&&... args) {
+        void* memory;
+        if (!_free.empty()) {
+            memory = _free.back();
+            _free.pop_back();
+        } else {
+            if (_used == block_size) {
+                _blocks.push_back(static_cast<Type*>(::operator new(sizeof(Type) * block_size)));
+                _used = 0;
+            }
+            memory = _blocks.back() + _used++;
+        }
+        return new (memory) Type(std::forward<Args>(args)...);
+    }
+
+    void destroy(Type* object) {
+        _free.push_back(object);
+    }
+
+    void clear() {
+        for (Type* block : _blocks) {
+            ::operator delete(block);
+        }
+        _blocks.clear();
+        _free.clear();
+        _used = block_size;
+    }
+};
+
+#endif /* defined(__LD29__Arena__) */
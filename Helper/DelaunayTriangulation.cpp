@@ -7,3 +7,615 @@
 //
 
 #include "DelaunayTriangulation.h"
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+// Is the circumcircle of a, b, c strictly between left and right? Evaluated
+// in double with a margin, so a circle that touches a limit counts as outside.
+static bool circle_between(Vector2 const& a, Vector2 const& b, Vector2 const& c, double left, double right) {
+    double bx = (double)b[0] - a[0];
+    double by = (double)b[1] - a[1];
+    double cx = (double)c[0] - a[0];
+    double cy = (double)c[1] - a[1];
+    double d = 2.0 * (bx * cy - by * cx);
+    if (d == 0.0) return false;
+    double b_lift = bx * bx + by * by;
+    double c_lift = cx * cx + cy * cy;
+    double ux = (cy * b_lift - by * c_lift) / d;
+    double uy = (bx * c_lift - cx * b_lift) / d;
+    double r = std::sqrt(ux * ux + uy * uy);
+    double center = a[0] + ux;
+    double margin = 1e-6 * (r + std::fabs(center));
+    return center - r - margin > left && center + r + margin < right;
+}
+
+static uint64_t edge_key(uint32_t v0, uint32_t v1) {
+    return (uint64_t)v0 << 32 | v1;
+}
+
+/*
+ * Splits the points into strips of equal size along x and triangulates each
+ * strip on its own thread. A face whose circumcircle lies strictly inside
+ * its strip cannot contain a point of another strip, so it is delaunay for
+ * all points and kept. The vertices of the other faces and of the strip
+ * hulls are triangulated once more; of that triangulation the faces on the
+ * other side of the kept ones' open edges (the seams) fill the gaps. Every
+ * vertex outside the gaps keeps its complete star from its strip, so the
+ * gaps hold exactly the remaining faces of the sequential mesh.
+ */
+void DelaunayTriangulation::triangulate_strips(std::vector<Point2*> const& points, InsertionOrder order, int strip_count) {
+    // sorted by x, without duplicates, which could end up in two strips
+    std::vector<uint32_t> sorted(points.size());
+    for (uint32_t i = 0; i < sorted.size(); ++i) {
+        sorted[i] = i;
+    }
+    std::sort(sorted.begin(), sorted.end(), [&](uint32_t i0, uint32_t i1) {
+        Vector2 const& l0 = points[i0]->l;
+        Vector2 const& l1 = points[i1]->l;
+        return l0[0] < l1[0] || (l0[0] == l1[0] && (l0[1] < l1[1] || (l0[1] == l1[1] && i0 < i1)));
+    });
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), [&](uint32_t i0, uint32_t i1) {
+        return points[i0]->l[0] == points[i1]->l[0] && points[i0]->l[1] == points[i1]->l[1];
+    }), sorted.end());
+
+    std::vector<size_t> bounds(strip_count + 1);
+    for (int j = 0; j <= strip_count; ++j) {
+        bounds[j] = sorted.size() * j / strip_count;
+    }
+    std::vector<std::unique_ptr<DelaunayTriangulation>> strips(strip_count);
+    std::vector<std::vector<uint32_t>> strip_sites(strip_count);
+    std::vector<std::thread> workers;
+    for (int j = 0; j < strip_count; ++j) {
+        workers.push_back(std::thread([&, j]() {
+            // in the order the points were given in
+            std::vector<uint32_t>& sites = strip_sites[j];
+            sites.assign(sorted.begin() + bounds[j], sorted.begin() + bounds[j + 1]);
+            std::sort(sites.begin(), sites.end());
+            std::vector<Point2*> strip(sites.size());
+            for (size_t i = 0; i < sites.size(); ++i) {
+                strip[i] = points[sites[i]];
+            }
+            strips[j].reset(new DelaunayTriangulation(strip, order));
+        }));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    _site_count = (uint32_t)points.size();
+    std::vector<uint32_t> offsets(strip_count);
+    for (int j = 0; j < strip_count; ++j) {
+        offsets[j] = (uint32_t)_points.size();
+        _points.insert(_points.end(), strips[j]->_points.begin(), strips[j]->_points.end());
+        for (uint32_t site : strips[j]->_sites) {
+            _sites.push_back(strip_sites[j][site]);
+        }
+    }
+    _locations.resize(_points.size());
+    for (size_t v = 0; v < _points.size(); ++v) {
+        _locations[v] = _points[v]->l;
+    }
+
+    std::vector<uint32_t> seams; // half edges of kept faces without a kept neighbour
+    std::vector<Point2*> gap_points;
+    std::unordered_map<Point2*, uint32_t> gap_vertices;
+    auto add_gap_vertex = [&](uint32_t v) {
+        if (gap_vertices.insert(std::make_pair(_points[v], v)).second) {
+            gap_points.push_back(_points[v]);
+        }
+    };
+
+    for (int j = 0; j < strip_count; ++j) {
+        HalfEdgeMesh const& strip = strips[j]->_mesh;
+        std::vector<Vector2> const& locations = strips[j]->_locations;
+        uint32_t offset = offsets[j];
+        double left = j > 0 ? points[sorted[bounds[j] - 1]]->l[0] : -std::numeric_limits<double>::infinity();
+        double right = j + 1 < strip_count ? points[sorted[bounds[j + 1]]]->l[0] : std::numeric_limits<double>::infinity();
+
+        if (strip.face_count() == 0) {
+            for (uint32_t v = 0; v < locations.size(); ++v) {
+                add_gap_vertex(offset + v);
+            }
+        }
+        std::vector<uint32_t> kept(strip.face_count(), no_index);
+        for (uint32_t f = 0; f < strip.face_count(); ++f) {
+            uint32_t v0 = strip.vertex[3 * f];
+            uint32_t v1 = strip.vertex[3 * f + 1];
+            uint32_t v2 = strip.vertex[3 * f + 2];
+            if (circle_between(locations[v0], locations[v1], locations[v2], left, right)) {
+                kept[f] = HalfEdgeMesh::face(_mesh.add_face(offset + v0, offset + v1, offset + v2));
+            } else {
+                add_gap_vertex(offset + v0);
+                add_gap_vertex(offset + v1);
+                add_gap_vertex(offset + v2);
+            }
+        }
+        for (uint32_t h = 0; h < strip.vertex.size(); ++h) {
+            uint32_t f = kept[HalfEdgeMesh::face(h)];
+            if (f == no_index) continue;
+            uint32_t t = strip.twin[h];
+            if (t != no_index && kept[HalfEdgeMesh::face(t)] != no_index) {
+                if (t > h) {
+                    _mesh.link(3 * f + h % 3, 3 * kept[HalfEdgeMesh::face(t)] + t % 3);
+                }
+            } else {
+                seams.push_back(3 * f + h % 3);
+                add_gap_vertex(offset + strip.vertex[h]);
+                add_gap_vertex(offset + strip.vertex[HalfEdgeMesh::next(h)]);
+            }
+        }
+    }
+    strips.clear();
+
+    DelaunayTriangulation gaps(gap_points, InsertBRIO);
+    HalfEdgeMesh const& mesh = gaps._mesh;
+    std::vector<uint32_t> global(gaps._points.size());
+    for (uint32_t v = 0; v < global.size(); ++v) {
+        global[v] = gap_vertices[gaps._points[v]];
+    }
+    std::unordered_map<uint64_t, uint32_t> edges;
+    for (uint32_t h = 0; h < mesh.vertex.size(); ++h) {
+        edges[edge_key(global[mesh.vertex[h]], global[mesh.vertex[HalfEdgeMesh::next(h)]])] = h;
+    }
+
+    // fill the gaps starting behind the seams, without crossing one
+    std::vector<char> gap_face(mesh.face_count(), seams.empty() ? 1 : 0);
+    std::vector<char> behind_seam(mesh.vertex.size(), 0);
+    std::vector<uint32_t> across(seams.size(), no_index);
+    std::vector<uint32_t> stack;
+    for (size_t i = 0; i < seams.size(); ++i) {
+        uint32_t h = seams[i];
+        auto it = edges.find(edge_key(_mesh.vertex[h], _mesh.vertex[HalfEdgeMesh::next(h)]));
+        if (it == edges.end()) {
+            // cocircular points, where the second triangulation chose another
+            // diagonal than a strip; start over without strips
+            _mesh = HalfEdgeMesh();
+            _points.clear();
+            _locations.clear();
+            _sites.clear();
+            for (Point2* p : points) {
+                p->on_hull = false;
+            }
+            triangulate(points, order);
+            return;
+        }
+        uint32_t t = mesh.twin[it->second];
+        if (t == no_index) continue; // on the hull of all points
+        across[i] = t;
+        behind_seam[t] = 1;
+        stack.push_back(HalfEdgeMesh::face(t));
+    }
+    while (stack.size() > 0) {
+        uint32_t f = stack.back();
+        stack.pop_back();
+        if (gap_face[f]) continue;
+        gap_face[f] = 1;
+        for (uint32_t h = 3 * f; h < 3 * f + 3; ++h) {
+            if (!behind_seam[h] && mesh.twin[h] != no_index) {
+                stack.push_back(HalfEdgeMesh::face(mesh.twin[h]));
+            }
+        }
+    }
+
+    std::vector<uint32_t> added(mesh.face_count(), no_index);
+    for (uint32_t f = 0; f < mesh.face_count(); ++f) {
+        if (gap_face[f]) {
+            added[f] = HalfEdgeMesh::face(_mesh.add_face(global[mesh.vertex[3 * f]], global[mesh.vertex[3 * f + 1]], global[mesh.vertex[3 * f + 2]]));
+        }
+    }
+    for (uint32_t h = 0; h < mesh.vertex.size(); ++h) {
+        uint32_t f = added[HalfEdgeMesh::face(h)];
+        uint32_t t = mesh.twin[h];
+        if (f != no_index && t != no_index && t > h && added[HalfEdgeMesh::face(t)] != no_index) {
+            _mesh.link(3 * f + h % 3, 3 * added[HalfEdgeMesh::face(t)] + t % 3);
+        }
+    }
+    for (size_t i = 0; i < seams.size(); ++i) {
+        if (across[i] != no_index) {
+            _mesh.link(seams[i], 3 * added[HalfEdgeMesh::face(across[i])] + across[i] % 3);
+        }
+    }
+
+    // the strips marked their own hulls
+    for (Point2* p : points) {
+        p->on_hull = false;
+    }
+    for (uint32_t h = 0; h < _mesh.twin.size(); ++h) {
+        if (_mesh.twin[h] == no_index) {
+            _points[_mesh.vertex[h]]->on_hull = true;
+        }
+    }
+    _last_face = 0;
+}
+
+/*
+ * p is outside the hull edge hull_edge. Every hull edge p can see gets a face
+ * with p; these edges are a chain around hull_edge, and the vertices inside
+ * the chain leave the hull. The old hull edges are then legalized like the
+ * edges opposite a point inserted inside.
+ */
+void DelaunayTriangulation::insert_outside(uint32_t v, uint32_t hull_edge) {
+    Vector2 const& p = _locations[v];
+    auto sees = [&](uint32_t h) {
+        return orient2d(start(h), start(HalfEdgeMesh::next(h)), p) < 0.0;
+    };
+    uint32_t first = hull_edge;
+    for (uint32_t h = previous_hull_edge(first); h != hull_edge && sees(h); h = previous_hull_edge(h)) {
+        first = h;
+    }
+    
+    std::vector<uint32_t>& stack = _legalize_stack;
+    stack.clear();
+    uint32_t h = first;
+    uint32_t previous = no_index;
+    while (true) {
+        uint32_t following = next_hull_edge(h);
+        uint32_t a = _mesh.vertex[h];
+        uint32_t b = _mesh.vertex[HalfEdgeMesh::next(h)];
+        uint32_t k = _mesh.add_face(b, a, v);
+        _mesh.link(k, h);
+        if (previous != no_index) {
+            _mesh.link(k + 1, previous + 2);
+            _points[a]->on_hull = false;
+        }
+        stack.push_back(k);
+        previous = k;
+        if (following == first || !sees(following)) break;
+        h = following;
+    }
+    _points[v]->on_hull = true;
+    _last_face = HalfEdgeMesh::face(previous);
+}
+
+/*
+ * The walk starts at the closest of about n^(1/3) random vertices and the
+ * last face (jump and walk), which keeps it short for edits anywhere on the
+ * map. Everything the insertion changed is in the star of the new vertex
+ * afterwards, so walking around it updates _edges and finds the changed
+ * cells.
+ */
+uint32_t DelaunayTriangulation::insert_site(Point2* p, std::vector<uint32_t>& changed) {
+    changed.clear();
+    if (_mesh.face_count() == 0) return no_index;
+    
+    uint32_t closest = _mesh.vertex[3 * _last_face];
+    float closest_distance = squared_length(_locations[closest] - p->l);
+    uint32_t samples = (uint32_t)std::cbrt((double)_points.size());
+    for (uint32_t i = 0; i < samples; ++i) {
+        uint32_t w = _walk_random() % _points.size();
+        if (_edges[w] == no_index) continue;
+        float distance = squared_length(_locations[w] - p->l);
+        if (distance < closest_distance) {
+            closest = w;
+            closest_distance = distance;
+        }
+    }
+    _last_face = HalfEdgeMesh::face(_edges[closest]);
+    
+    p->on_hull = false;
+    uint32_t v = add_vertex(p, _site_count);
+    if (!insert(v)) {
+        _points.pop_back();
+        _locations.pop_back();
+        _sites.pop_back();
+        return no_index;
+    }
+    _vertices.push_back(v);
+    // the faces around v keep it through the flips, the last one included
+    _edges.push_back(3 * _last_face);
+    while (_mesh.vertex[_edges[v]] != v) {
+        ++_edges[v];
+    }
+    
+    changed.push_back(_site_count);
+    uint32_t first = outgoing(v);
+    uint32_t h = first;
+    do {
+        uint32_t n = HalfEdgeMesh::next(h);
+        _edges[_mesh.vertex[n]] = n;
+        changed.push_back(site(_mesh.vertex[n]));
+        uint32_t back = HalfEdgeMesh::previous(h);
+        if (_mesh.twin[back] == no_index) {
+            _edges[_mesh.vertex[back]] = back;
+            changed.push_back(site(_mesh.vertex[back]));
+            break;
+        }
+        h = _mesh.twin[back];
+    } while (h != first);
+    _faces.clear();
+    _face_arena.clear();
+    return _site_count++;
+}
+
+/*
+ * Fills the hole v leaves with ears whose circumcircle holds none of the
+ * neighbours of v. These are triangles of the Delaunay triangulation without
+ * v, and a polygon always has one while it is not a triangle, so nothing
+ * needs to be flipped afterwards. Around a hull vertex the hole is only
+ * filled up to the convex hull of the neighbours, which is where the new
+ * hull runs. The new faces take the slots of the old ones, the rest of the
+ * slots are removed, which moves the last faces of the mesh; _edges follows
+ * both. neighbours receives the neighbours of v.
+ */
+bool DelaunayTriangulation::remove(uint32_t v, std::vector<uint32_t>& neighbours) {
+    uint32_t first = outgoing(v);
+    if (first == no_index) return false;
+    
+    // the star of v counter clockwise; boundary edge i of the hole runs from
+    // neighbour i to the next one, with outside[i] across it
+    std::vector<uint32_t> faces;
+    std::vector<uint32_t> outside;
+    neighbours.clear();
+    uint32_t h = first;
+    do {
+        faces.push_back(HalfEdgeMesh::face(h));
+        neighbours.push_back(_mesh.vertex[HalfEdgeMesh::next(h)]);
+        outside.push_back(_mesh.twin[HalfEdgeMesh::next(h)]);
+        uint32_t back = HalfEdgeMesh::previous(h);
+        if (_mesh.twin[back] == no_index) {
+            neighbours.push_back(_mesh.vertex[back]);
+            break;
+        }
+        h = _mesh.twin[back];
+    } while (h != first);
+    uint32_t n = (uint32_t)neighbours.size();
+    bool on_hull = n > faces.size();
+    auto location = [&](uint32_t i) -> Vector2 const& {
+        return _locations[neighbours[i]];
+    };
+    
+    // the polygons to fill, as positions in neighbours
+    std::vector<std::vector<uint32_t>> holes;
+    std::vector<uint32_t> lid;
+    if (on_hull) {
+        // the hull of the neighbours on the side of v, from the first one to
+        // the last; the neighbours are sorted by angle around v
+        for (uint32_t i = 0; i < n; ++i) {
+            while (lid.size() >= 2 && orient2d(location(lid[lid.size() - 2]), location(lid.back()), location(i)) > 0.0) {
+                lid.pop_back();
+            }
+            lid.push_back(i);
+        }
+        for (size_t j = 0; j + 1 < lid.size(); ++j) {
+            if (lid[j + 1] > lid[j] + 1) {
+                holes.push_back(std::vector<uint32_t>());
+                for (uint32_t i = lid[j]; i <= lid[j + 1]; ++i) {
+                    holes.back().push_back(i);
+                }
+            }
+        }
+    } else {
+        holes.push_back(std::vector<uint32_t>());
+        for (uint32_t i = 0; i < n; ++i) {
+            holes.back().push_back(i);
+        }
+    }
+    
+    std::vector<uint32_t> triangles;
+    for (std::vector<uint32_t>& polygon : holes) {
+        while (polygon.size() > 3) {
+            size_t ear = polygon.size();
+            for (size_t k = 0; k < polygon.size() && ear == polygon.size(); ++k) {
+                uint32_t a = polygon[k > 0 ? k - 1 : polygon.size() - 1];
+                uint32_t b = polygon[k];
+                uint32_t c = polygon[k + 1 < polygon.size() ? k + 1 : 0];
+                if (orient2d(location(a), location(b), location(c)) <= 0.0) continue;
+                ear = k;
+                for (uint32_t i = 0; i < n; ++i) {
+                    if (i != a && i != b && i != c && incircle(location(a), location(b), location(c), location(i)) > 0.0) {
+                        ear = polygon.size();
+                        break;
+                    }
+                }
+            }
+            if (ear == polygon.size()) return false;
+            triangles.push_back(polygon[ear > 0 ? ear - 1 : polygon.size() - 1]);
+            triangles.push_back(polygon[ear]);
+            triangles.push_back(polygon[ear + 1 < polygon.size() ? ear + 1 : 0]);
+            polygon.erase(polygon.begin() + ear);
+        }
+        triangles.insert(triangles.end(), polygon.begin(), polygon.end());
+    }
+    uint32_t count = (uint32_t)triangles.size() / 3;
+    if (count == 0 && faces.size() == _mesh.face_count()) return false;
+    
+    // boundary edges that are not covered by a new face end up on the hull,
+    // as do the lid edges of the filled pockets
+    for (uint32_t t : outside) {
+        if (t != no_index) {
+            _mesh.twin[t] = no_index;
+        }
+    }
+    std::sort(faces.begin(), faces.end());
+    std::vector<uint32_t> open; // diagonals seen once: start, end, half edge
+    for (uint32_t t = 0; t < count; ++t) {
+        uint32_t f = faces[t];
+        for (uint32_t i = 0; i < 3; ++i) {
+            _mesh.vertex[3 * f + i] = neighbours[triangles[3 * t + i]];
+            _mesh.twin[3 * f + i] = no_index;
+        }
+        for (uint32_t i = 0; i < 3; ++i) {
+            uint32_t a = triangles[3 * t + i];
+            uint32_t b = triangles[3 * t + (i + 1) % 3];
+            if (b == a + 1 || (!on_hull && a == n - 1 && b == 0)) {
+                _mesh.link(3 * f + i, outside[a]);
+                continue;
+            }
+            size_t k = 0;
+            while (k < open.size() && (open[k] != b || open[k + 1] != a)) {
+                k += 3;
+            }
+            if (k < open.size()) {
+                _mesh.link(3 * f + i, open[k + 2]);
+                open.erase(open.begin() + k, open.begin() + k + 3);
+            } else {
+                open.push_back(a);
+                open.push_back(b);
+                open.push_back(3 * f + i);
+            }
+        }
+    }
+    for (uint32_t i : lid) {
+        _points[neighbours[i]]->on_hull = true;
+    }
+    for (uint32_t h = 0; h < 3 * count; ++h) {
+        uint32_t g = 3 * faces[h / 3] + h % 3;
+        _edges[_mesh.vertex[g]] = g;
+    }
+    for (uint32_t t : outside) {
+        if (t != no_index) {
+            _edges[_mesh.vertex[t]] = t;
+            _edges[_mesh.vertex[HalfEdgeMesh::next(t)]] = HalfEdgeMesh::next(t);
+        }
+    }
+    _edges[v] = no_index;
+    
+    // the highest slots go, so the reused ones are not moved
+    for (size_t t = faces.size(); t-- > count;) {
+        uint32_t f = faces[t];
+        bool moves = f != _mesh.face_count() - 1;
+        _mesh.remove_face(f);
+        for (uint32_t g = 3 * f; moves && g < 3 * f + 3; ++g) {
+            _edges[_mesh.vertex[g]] = g;
+        }
+    }
+    _last_face = count > 0 ? faces[0] : 0;
+    return true;
+}
+
+// Sutherland-Hodgman against the four sides of the box
+static void clip_to_box(std::vector<Vector2>& polygon, Vector2 const& lower, Vector2 const& upper, std::vector<Vector2>& scratch) {
+    for (int side = 0; side < 4; ++side) {
+        int axis = side % 2;
+        float limit = side < 2 ? lower[axis] : upper[axis];
+        float direction = side < 2 ? 1.0f : -1.0f; // inside if direction * (p - limit) >= 0
+        scratch.clear();
+        for (size_t i0 = 0; i0 < polygon.size(); ++i0) {
+            size_t i1 = i0+1 < polygon.size() ? i0+1 : 0;
+            float d0 = direction * (polygon[i0][axis] - limit);
+            float d1 = direction * (polygon[i1][axis] - limit);
+            if (d0 >= 0.0f) {
+                scratch.push_back(polygon[i0]);
+            }
+            if ((d0 >= 0.0f) != (d1 >= 0.0f)) {
+                scratch.push_back(polygon[i0] + (d0 / (d0 - d1)) * (polygon[i1] - polygon[i0]));
+            }
+        }
+        polygon.swap(scratch);
+    }
+}
+
+/*
+ * Closes the cell of a hull site far outside the box and clips a cell that
+ * leaves the box. first and last are the outgoing half edges of the first
+ * and the last face of the walk around the site.
+ */
+void DelaunayTriangulation::close_cell(uint32_t first, uint32_t last, bool open, Vector2 const& lower, Vector2 const& upper,
+                                       std::vector<Vector2>& polygon, std::vector<Vector2>& scratch) const {
+    if (open) {
+        Vector2 const& site = start(first);
+        Vector2 out = start(HalfEdgeMesh::next(first)) - site;
+        Vector2 in = site - start(HalfEdgeMesh::previous(last));
+        Vector2 n_first = vector_normal(Vector2(out[1], -out[0]));
+        Vector2 n_last = vector_normal(Vector2(in[1], -in[0]));
+        float reach = length(upper - lower) + length(site - 0.5f * (lower + upper));
+        for (Vector2 const& c : polygon) {
+            reach = std::max(reach, length(c - site));
+        }
+        reach *= 4.0f;
+        polygon.insert(polygon.begin(), polygon.front() + reach * n_first);
+        polygon.push_back(polygon.back() + reach * n_last);
+        polygon.push_back(site + reach * vector_normal(n_first + n_last));
+    }
+    
+    for (Vector2 const& c : polygon) {
+        if (c[0] < lower[0] || c[1] < lower[1] || c[0] > upper[0] || c[1] > upper[1]) {
+            clip_to_box(polygon, lower, upper, scratch);
+            break;
+        }
+    }
+}
+
+/*
+ * The corners of a cell are the circumcenters of the faces around its site,
+ * so walking the faces counter clockwise gives the polygon in one pass over
+ * the mesh, every circumcenter computed once. The cells of hull sites are
+ * open between the rays along their two hull edges; they are closed far
+ * outside the box, with an extra corner in the middle so the closing edges
+ * do not cut into the box, and clipped. Cells are independent of each other
+ * once the circumcenters are known.
+ */
+VoronoiPolygons DelaunayTriangulation::voronoi_polygons(Vector2 const& lower, Vector2 const& upper) const {
+    VoronoiPolygons result;
+    result.offsets.assign(_site_count + 1, 0);
+    
+    std::vector<Vector2> centers(_mesh.face_count());
+    for (uint32_t f = 0; f < centers.size(); ++f) {
+        centers[f] = circumcenter(start(3 * f), start(3 * f + 1), start(3 * f + 2));
+    }
+    // an outgoing half edge per vertex, for hull vertices the one on the hull,
+    // where the counter clockwise walk starts
+    std::vector<uint32_t> outgoing(_points.size(), no_index);
+    for (uint32_t h = 0; h < _mesh.vertex.size(); ++h) {
+        uint32_t v = _mesh.vertex[h];
+        if (outgoing[v] == no_index || _mesh.twin[h] == no_index) {
+            outgoing[v] = h;
+        }
+    }
+    
+    // cells in vertex order, which follows the mesh, then moved to site order
+    std::vector<uint32_t> offsets(_points.size() + 1, 0);
+    std::vector<Vector2> corners;
+    corners.reserve(_mesh.vertex.size());
+    std::vector<Vector2> polygon;
+    std::vector<Vector2> scratch;
+    for (uint32_t v = 0; v < _points.size(); ++v) {
+        offsets[v] = (uint32_t)corners.size();
+        if (outgoing[v] == no_index) continue;
+        
+        polygon.clear();
+        uint32_t first = outgoing[v];
+        uint32_t last = first;
+        uint32_t h = first;
+        do {
+            polygon.push_back(centers[HalfEdgeMesh::face(h)]);
+            last = h;
+            h = _mesh.twin[HalfEdgeMesh::previous(h)];
+        } while (h != no_index && h != first);
+        close_cell(first, last, h == no_index, lower, upper, polygon, scratch);
+        corners.insert(corners.end(), polygon.begin(), polygon.end());
+    }
+    offsets[_points.size()] = (uint32_t)corners.size();
+    
+    result.corners.resize(corners.size());
+    for (uint32_t s = 0; s < _site_count; ++s) {
+        uint32_t v = _vertices[s];
+        if (v == no_index) {
+            result.offsets[s + 1] = result.offsets[s];
+            continue;
+        }
+        std::copy(corners.begin() + offsets[v], corners.begin() + offsets[v + 1], result.corners.begin() + result.offsets[s]);
+        result.offsets[s + 1] = result.offsets[s] + offsets[v + 1] - offsets[v];
+    }
+    return result;
+}
+
+void DelaunayTriangulation::voronoi_polygon(uint32_t site, Vector2 const& lower, Vector2 const& upper, std::vector<Vector2>& polygon) const {
+    polygon.clear();
+    uint32_t v = site < _site_count ? _vertices[site] : no_index;
+    uint32_t first = v != no_index ? outgoing(v) : no_index;
+    if (first == no_index) return;
+    uint32_t last = first;
+    uint32_t h = first;
+    do {
+        uint32_t f = HalfEdgeMesh::face(h);
+        polygon.push_back(circumcenter(start(3 * f), start(3 * f + 1), start(3 * f + 2)));
+        last = h;
+        h = _mesh.twin[HalfEdgeMesh::previous(h)];
+    } while (h != no_index && h != first);
+    std::vector<Vector2> scratch;
+    close_cell(first, last, h == no_index, lower, upper, polygon, scratch);
+}
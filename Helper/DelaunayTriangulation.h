@@ -9,163 +9,466 @@
 #ifndef __LD29__DelaunayTriangulation__
 #define __LD29__DelaunayTriangulation__
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <set>
 #include <map>
 #include "Geometry.h"
+#include "HalfEdgeMesh.h"
+
+typedef enum {
+    InsertInOrder,  // the order the points are given in
+    InsertBRIO      // biased randomized rounds along a Hilbert curve, see brio_order
+} InsertionOrder;
+
+/*
+ * Neighbours of sites in compressed sparse rows: the neighbours of site i
+ * are neighbours[offsets[i]] up to neighbours[offsets[i + 1]], ascending.
+ * Sites are positions in the triangulated point list.
+ */
+struct SiteAdjacency {
+    std::vector<uint32_t> offsets; // one more than there are sites
+    std::vector<uint32_t> neighbours;
+    
+    uint32_t site_count() const { return offsets.empty() ? 0 : (uint32_t)offsets.size() - 1; }
+    uint32_t degree(uint32_t site) const { return offsets[site + 1] - offsets[site]; }
+    uint32_t const* begin(uint32_t site) const { return neighbours.data() + offsets[site]; }
+    uint32_t const* end(uint32_t site) const { return neighbours.data() + offsets[site + 1]; }
+};
+
+/*
+ * Voronoi cells as polygons in compressed rows: the corners of the cell of
+ * site i, counter clockwise, are corners[offsets[i]] up to
+ * corners[offsets[i + 1]].
+ */
+struct VoronoiPolygons {
+    std::vector<uint32_t> offsets; // one more than there are sites
+    std::vector<Vector2> corners;
+    
+    Vector2 const* begin(uint32_t site) const { return corners.data() + offsets[site]; }
+    Vector2 const* end(uint32_t site) const { return corners.data() + offsets[site + 1]; }
+};
 
 class DelaunayTriangulation {
-    std::vector<Face2*> _faces;
-    
-    std::vector<Face2*>::iterator find_triangle(Point2* p) {
-        std::vector<Face2*>::iterator it;
-        for (it = _faces.begin(); it != _faces.end(); ++it) {
-            Face2* f = *it;
-            if (ccw(f->p[0], f->p[1], p) &&
-                ccw(f->p[1], f->p[2], p) &&
-                ccw(f->p[2], f->p[0], p)) {
-                return it;
+    HalfEdgeMesh _mesh;
+    std::vector<Point2*> _points; // mesh vertex -> point
+    std::vector<Vector2> _locations; // mesh vertex -> location, in insertion order
+    std::vector<uint32_t> _sites; // mesh vertex -> position in the given points
+    std::vector<uint32_t> _vertices; // site -> mesh vertex, no_index if not in the mesh
+    std::vector<uint32_t> _edges; // mesh vertex -> a half edge starting there, kept up to date by edits
+    uint32_t _site_count;
+    
+    uint32_t _last_face;
+    RandomStream _walk_random;
+    
+    // half edges that may not be delaunay yet; a member, so the memory is
+    // reused by every insertion
+    std::vector<uint32_t> _legalize_stack;
+    
+    // Face2 view of the mesh, built by the first call to faces() after a change
+    mutable Arena<Face2> _face_arena;
+    mutable std::vector<Face2*> _faces;
+    
+    uint32_t add_vertex(Point2* p, uint32_t site) {
+        _points.push_back(p);
+        _locations.push_back(p->l);
+        _sites.push_back(site);
+        return (uint32_t)_points.size() - 1;
+    }
+    
+    Vector2 const& start(uint32_t h) const {
+        return _locations[_mesh.vertex[h]];
+    }
+    
+    // is the vertex opposite h in the twin face outside the circumcircle of
+    // the face of h?
+    bool legal(uint32_t h) const {
+        uint32_t t = _mesh.twin[h];
+        if (t == no_index) return true;
+        uint32_t h1 = HalfEdgeMesh::next(h);
+        uint32_t h2 = HalfEdgeMesh::next(h1);
+        return incircle(start(h), start(h1), start(h2), start(HalfEdgeMesh::previous(t))) <= 0.0;
+    }
+    
+    // Remembering stochastic walk: starting at the last created face, cross
+    // any edge that has p on its outer side until p is inside. The edge tests
+    // start at a random edge, which keeps the walk from cycling, and the edge
+    // the walk came through is not tested again. For spatially coherent input
+    // the walk takes a few steps per point. If p is outside the convex hull,
+    // the hull edge it is outside of is returned in hull_edge.
+    uint32_t find_triangle(Vector2 const& p, uint32_t& hull_edge) {
+        uint32_t f = _last_face;
+        uint32_t previous = no_index;
+        while (true) {
+            uint32_t first = _walk_random() % 3;
+            uint32_t next = no_index;
+            for (uint32_t k = 0; k < 3; ++k) {
+                uint32_t h = 3 * f + (first + k) % 3;
+                uint32_t t = _mesh.twin[h];
+                if (t != no_index && HalfEdgeMesh::face(t) == previous) continue;
+                if (orient2d(start(h), start(HalfEdgeMesh::next(h)), p) < 0.0) {
+                    // an edge without a neighbour: p is outside the convex hull
+                    if (t == no_index) {
+                        hull_edge = h;
+                        return no_index;
+                    }
+                    next = HalfEdgeMesh::face(t);
+                    break;
+                }
             }
+            if (next == no_index) return f;
+            previous = f;
+            f = next;
         }
-        return it;
     }
     
-public:
-    DelaunayTriangulation(std::vector<Point2*> const& points) {
-        // create initial convex shape surrounding all points
-        std::vector<Point2*> hull = convex_hull(points);
-        for (Point2* p : hull) {
-            p->on_hull = true;
+    // the hull edges before and after the hull edge h, counter clockwise
+    uint32_t next_hull_edge(uint32_t h) const {
+        uint32_t g = HalfEdgeMesh::next(h);
+        while (_mesh.twin[g] != no_index) {
+            g = HalfEdgeMesh::next(_mesh.twin[g]);
         }
-        _faces = triangulate_convex(hull);
-        
-        // handle remaining points
-        for (Point2* p : points) {
-            if (std::find(hull.begin(), hull.end(), p) != hull.end()) continue;
-            
-            std::vector<Face2*>::iterator it = find_triangle(p);
-            if (it == _faces.end()) {
-                std::cout << "WARNING: No triangle found." << std::endl;
-                continue;
+        return g;
+    }
+    uint32_t previous_hull_edge(uint32_t h) const {
+        uint32_t g = HalfEdgeMesh::previous(h);
+        while (_mesh.twin[g] != no_index) {
+            g = HalfEdgeMesh::previous(_mesh.twin[g]);
+        }
+        return g;
+    }
+    
+    // see DelaunayTriangulation.cpp
+    void insert_outside(uint32_t v, uint32_t hull_edge);
+    bool remove(uint32_t v, std::vector<uint32_t>& neighbours);
+    
+    // the outgoing half edge of v where counter clockwise walks around v
+    // start, the one on the hull for hull vertices
+    uint32_t outgoing(uint32_t v) const {
+        uint32_t h = _edges[v];
+        if (h == no_index) return no_index;
+        uint32_t g = h;
+        while (_mesh.twin[g] != no_index) {
+            g = HalfEdgeMesh::next(_mesh.twin[g]);
+            if (g == h) break;
+        }
+        return g;
+    }
+    void close_cell(uint32_t first, uint32_t last, bool open, Vector2 const& lower, Vector2 const& upper,
+                    std::vector<Vector2>& polygon, std::vector<Vector2>& scratch) const;
+    
+    // false for a duplicate, which is left out of the mesh
+    bool insert(uint32_t v) {
+        Vector2 const& p = _locations[v];
+        uint32_t hull_edge = no_index;
+        uint32_t f = find_triangle(p, hull_edge);
+        std::vector<uint32_t>& stack = _legalize_stack;
+        if (f == no_index) {
+            insert_outside(v, hull_edge);
+        } else {
+            // is this point on an edge?
+            uint32_t edge = no_index;
+            for (uint32_t h = 3 * f; h < 3 * f + 3; ++h) {
+                Vector2 const& p0 = start(h);
+                if (p0[0] == p[0] && p0[1] == p[1]) return false; // a duplicate
+                if (orient2d(p0, p, start(HalfEdgeMesh::next(h))) == 0.0) {
+                    edge = h;
+                }
             }
             
-            // is this point part of the convex hull?
-            int edge = -1;
-            for (int i = 0; i < 3; ++i) {
-                if (area((*it)->p[i], p, (*it)->p[ccw_next(i)]) == 0) {
-                    edge = i;
+            // insert point, the edges opposite it are the ones to check
+            uint32_t opposite[4];
+            int count = 3;
+            if (edge == no_index) {
+                _mesh.split(f, v, opposite);
+            } else {
+                count = _mesh.split_edge(edge, v, opposite);
+                if (count == 2) {
+                    _points[v]->on_hull = true;
                 }
             }
-            // insert point
-            std::set<Face2*> stack;
-            if (edge < 0) {
-                Face2* new0, *new1, *new2;
-                split(*it, p, &new0, &new1, &new2);
-                delete *it;
-                _faces.erase(it);
-                _faces.push_back(new0);
-                _faces.push_back(new1);
-                _faces.push_back(new2);
-                stack.insert(new0);
-                stack.insert(new1);
-                stack.insert(new2);
-            } else {
-                p->on_hull = true;
-                Face2* new0, *new1;
-                split_edge(*it, edge, p, &new0, &new1);
-                delete *it;
-                _faces.erase(it);
-                _faces.push_back(new0);
-                _faces.push_back(new1);
-                stack.insert(new0);
-                stack.insert(new1);
+            _last_face = _mesh.face_count() - 1;
+            stack.assign(opposite, opposite + count);
+        }
+        
+        // make the mesh delaunay; after a flip v is opposite two new edges
+        while (stack.size() > 0) {
+            uint32_t h = stack.back();
+            stack.pop_back();
+            if (!legal(h)) {
+                uint32_t diagonal = _mesh.flip(h);
+                stack.push_back(HalfEdgeMesh::previous(diagonal));
+                stack.push_back(HalfEdgeMesh::next(_mesh.twin[diagonal]));
             }
-            
-            // make the mesh delaunay
-            while (stack.size() > 0) {
-                Face2* f = *stack.begin();
-                stack.erase(stack.begin());
-                for (int i0 = 0; i0 < 3; ++i0) {
-                    Face2* n = neighbour(f, i0);
-                    if (n) {
-                        int j0 = f->e[i0].e->i;
-                        int j1 = ccw_next(j0);
-                        int j2 = cw_next(j0);
-                        int i1 = ccw_next(i0);
-                        int i2 = cw_next(i0);
-                        if (in_circle(f->p[i0], f->p[i1], f->p[i2], n->p[j2])) {
-                            Face2* f0 = neighbour(f, i1);
-                            Face2* f1 = neighbour(f, i2);
-                            Face2* f2 = neighbour(n, j1);
-                            Face2* f3 = neighbour(n, j2);
-                            flip(f, i0, n, j0);
-                            if (f0) stack.insert(f0);
-                            if (f1) stack.insert(f1);
-                            if (f2) stack.insert(f2);
-                            if (f3) stack.insert(f3);
-                            break;
-                        }
-                    }
-                }
+        }
+        return true;
+    }
+    
+    // a fan from hull[0], flipped until delaunay
+    void triangulate_hull(std::vector<Point2*> const& hull, std::vector<uint32_t> const& sites) {
+        uint32_t v0 = add_vertex(hull[0], sites[0]);
+        uint32_t v1 = add_vertex(hull[1], sites[1]);
+        uint32_t previous = no_index;
+        for (size_t i = 2; i < hull.size(); ++i) {
+            uint32_t v2 = add_vertex(hull[i], sites[i]);
+            uint32_t h = _mesh.add_face(v0, v1, v2);
+            if (previous != no_index) {
+                _mesh.link(h, previous + 2);
             }
+            previous = h;
+            v1 = v2;
         }
+        
+        std::vector<uint32_t>& stack = _legalize_stack;
+        for (uint32_t h = 0; h < _mesh.twin.size(); ++h) {
+            if (_mesh.twin[h] != no_index && _mesh.twin[h] > h) {
+                stack.push_back(h);
+            }
+        }
+        while (stack.size() > 0) {
+            uint32_t h = stack.back();
+            stack.pop_back();
+            if (!legal(h)) {
+                uint32_t diagonal = _mesh.flip(h);
+                uint32_t t = _mesh.twin[diagonal];
+                stack.push_back(HalfEdgeMesh::next(diagonal));
+                stack.push_back(HalfEdgeMesh::previous(diagonal));
+                stack.push_back(HalfEdgeMesh::next(t));
+                stack.push_back(HalfEdgeMesh::previous(t));
+            }
+        }
+        _last_face = _mesh.face_count() - 1;
     }
-
-    ~DelaunayTriangulation() {
-        for (Face2* f : _faces) {
-            delete f;
+    
+    void triangulate(std::vector<Point2*> const& points, InsertionOrder order) {
+        _site_count = (uint32_t)points.size();
+        _points.reserve(points.size());
+        _locations.reserve(points.size());
+        _sites.reserve(points.size());
+        _mesh.vertex.reserve(points.size() * 6);
+        _mesh.twin.reserve(points.size() * 6);
+        
+        // create initial convex shape surrounding all points
+        std::vector<Point2*> hull = convex_hull(points);
+        if (hull.size() < 3) return;
+        for (Point2* p : hull) {
+            p->on_hull = true;
+        }
+        std::vector<Point2*> sorted_hull = hull;
+        std::sort(sorted_hull.begin(), sorted_hull.end());
+        std::vector<uint32_t> hull_sites(hull.size(), no_index);
+        for (uint32_t i = 0; i < points.size(); ++i) {
+            auto it = std::lower_bound(sorted_hull.begin(), sorted_hull.end(), points[i]);
+            if (it != sorted_hull.end() && *it == points[i]) {
+                size_t k = std::find(hull.begin(), hull.end(), points[i]) - hull.begin();
+                if (hull_sites[k] == no_index) hull_sites[k] = i;
+            }
+        }
+        triangulate_hull(hull, hull_sites);
+        
+        std::vector<uint32_t> ordered;
+        if (order == InsertBRIO) {
+            ordered = brio_permutation(points, _walk_random);
+        } else {
+            ordered.resize(points.size());
+            for (uint32_t i = 0; i < ordered.size(); ++i) {
+                ordered[i] = i;
+            }
+        }
+        
+        // handle remaining points
+        for (uint32_t i : ordered) {
+            if (std::binary_search(sorted_hull.begin(), sorted_hull.end(), points[i])) continue;
+            insert(add_vertex(points[i], i));
+        }
+    }
+    
+    // see DelaunayTriangulation.cpp
+    void triangulate_strips(std::vector<Point2*> const& points, InsertionOrder order, int strip_count);
+    
+public:
+    /*
+     * With InsertBRIO consecutive points are close to each other, so the
+     * point location walks stay short, while the randomized rounds keep the
+     * expected construction time at O(n log n) for any input order.
+     *
+     * With more than one thread the points are split into vertical strips
+     * that are triangulated in parallel and stitched together. For points in
+     * general position the mesh has the same triangles as the sequential one,
+     * in a different order.
+     */
+    DelaunayTriangulation(std::vector<Point2*> const& points, InsertionOrder order = InsertInOrder, int threads = 1) : _last_face(0) {
+        static const int min_strip_size = 4096;
+        int strip_count = std::min(threads, (int)(points.size() / min_strip_size));
+        if (strip_count > 1) {
+            triangulate_strips(points, order, strip_count);
+        } else {
+            triangulate(points, order);
+        }
+        _vertices.assign(_site_count, no_index);
+        _edges.assign(_points.size(), no_index);
+        for (uint32_t h = 0; h < _mesh.vertex.size(); ++h) {
+            _vertices[_sites[_mesh.vertex[h]]] = _mesh.vertex[h];
+            _edges[_mesh.vertex[h]] = h;
         }
     }
     
     void vertex_data(std::vector<Vector3>& vertices) const {
-        vertices.resize(_faces.size() * 3);
-        for (int i = 0; i < _faces.size(); ++i) {
-            vertices[i * 3 + 0] = Vector3(_faces[i]->p[0]->l[0], 0.0f, _faces[i]->p[0]->l[1]);
-            vertices[i * 3 + 1] = Vector3(_faces[i]->p[1]->l[0], 0.0f, _faces[i]->p[1]->l[1]);
-            vertices[i * 3 + 2] = Vector3(_faces[i]->p[2]->l[0], 0.0f, _faces[i]->p[2]->l[1]);
+        vertices.resize(_mesh.vertex.size());
+        for (size_t h = 0; h < _mesh.vertex.size(); ++h) {
+            Vector2 const& l = start((uint32_t)h);
+            vertices[h] = Vector3(l[0], 0.0f, l[1]);
         }
     }
     
-    std::vector<Face2*> const& faces() const { return _faces; }
-};
-
-class VoronoiDiagram {
-    std::vector<VoronoiCell2*> _cells;
+    HalfEdgeMesh const& mesh() const { return _mesh; }
+    Point2* point(uint32_t vertex) const { return _points[vertex]; }
+    // position of the vertex in the points the triangulation was built from
+    uint32_t site(uint32_t vertex) const { return _sites[vertex]; }
+    // the mesh vertex of a site, no_index for dropped duplicates and removed sites
+    uint32_t vertex(uint32_t site) const { return _vertices[site]; }
+    uint32_t site_count() const { return _site_count; }
     
-public:
-    VoronoiDiagram(float width, float height, std::vector<Point2*> const& points) {
-        DelaunayTriangulation dt(points);
-        std::map<Point2*, std::set<Point2*>> neighbours;
-        for (Face2* f : dt.faces()) {
-            for (int i = 0; i < 3; ++i) {
-                Point2* p0 = f->p[i];
-                Point2* p1 = f->p[ccw_next(i)];
-                Point2* p2 = f->p[cw_next(i)];
-                neighbours[p0].insert(p1);
-                neighbours[p0].insert(p2);
+    /*
+     * Adds p as the site site_count() and repairs the mesh around it, also
+     * outside the convex hull; the mesh must have a face already. Returns the
+     * new site, or no_index if p is a duplicate. changed receives the sites
+     * whose Voronoi cells changed: the new one and its neighbours.
+     */
+    uint32_t insert_site(Point2* p, std::vector<uint32_t>& changed);
+    
+    /*
+     * Takes the site out of the mesh and retriangulates the hole it leaves;
+     * the site keeps its number, without a vertex. Fails for sites that are
+     * not in the mesh and if no face would be left. changed receives the
+     * sites whose Voronoi cells changed: the removed one and its neighbours.
+     */
+    bool remove_site(uint32_t site, std::vector<uint32_t>& changed) {
+        changed.clear();
+        uint32_t v = site < _site_count ? _vertices[site] : no_index;
+        if (v == no_index || !remove(v, changed)) return false;
+        for (uint32_t& c : changed) {
+            c = _sites[c];
+        }
+        changed.insert(changed.begin(), site);
+        _vertices[site] = no_index;
+        _points[v]->on_hull = false;
+        _faces.clear();
+        _face_arena.clear();
+        return true;
+    }
+    
+    // the edges of the mesh by site, sites that are not in the mesh (dropped
+    // duplicates) have no neighbours
+    SiteAdjacency adjacency() const {
+        SiteAdjacency result;
+        result.offsets.assign(_site_count + 1, 0);
+        for (uint32_t h = 0; h < _mesh.vertex.size(); ++h) {
+            uint32_t t = _mesh.twin[h];
+            if (t == no_index || t > h) {
+                result.offsets[site(_mesh.vertex[h]) + 1]++;
+                result.offsets[site(_mesh.vertex[HalfEdgeMesh::next(h)]) + 1]++;
             }
         }
-        
-        std::map<Point2*, VoronoiCell2*> cells;
-        for (auto it : neighbours) {
-            cells.insert(std::make_pair(it.first, new VoronoiCell2(it.first)));
+        for (uint32_t i = 0; i < _site_count; ++i) {
+            result.offsets[i + 1] += result.offsets[i];
         }
-        
-        for (auto it : cells) {
-            _cells.push_back(it.second);
-            for (Point2* n : neighbours[it.first]) {
-                _cells.back()->n.push_back(cells[n]);
+        result.neighbours.resize(result.offsets[_site_count]);
+        std::vector<uint32_t> filled(result.offsets.begin(), result.offsets.end() - 1);
+        for (uint32_t h = 0; h < _mesh.vertex.size(); ++h) {
+            uint32_t t = _mesh.twin[h];
+            if (t == no_index || t > h) {
+                uint32_t s0 = site(_mesh.vertex[h]);
+                uint32_t s1 = site(_mesh.vertex[HalfEdgeMesh::next(h)]);
+                result.neighbours[filled[s0]++] = s1;
+                result.neighbours[filled[s1]++] = s0;
             }
         }
+        for (uint32_t i = 0; i < _site_count; ++i) {
+            std::sort(result.neighbours.begin() + result.offsets[i], result.neighbours.begin() + result.offsets[i + 1]);
+        }
+        return result;
     }
-    ~VoronoiDiagram() {
-        for (VoronoiCell2* c : _cells) {
-            delete c;
+    
+    // see DelaunayTriangulation.cpp
+    VoronoiPolygons voronoi_polygons(Vector2 const& lower, Vector2 const& upper) const;
+    
+    // the cell of one site as in voronoi_polygons, possibly starting at
+    // another corner, for updating the cells that changed after an insertion
+    // or removal; empty for sites without a vertex
+    void voronoi_polygon(uint32_t site, Vector2 const& lower, Vector2 const& upper, std::vector<Vector2>& polygon) const;
+    
+    // the mesh as linked Face2s, face i of the mesh is faces()[i]
+    std::vector<Face2*> const& faces() const {
+        if (_faces.empty()) {
+            for (uint32_t h = 0; h < _mesh.vertex.size(); h += 3) {
+                Face2* f = _face_arena.create(point(_mesh.vertex[h]), point(_mesh.vertex[h + 1]), point(_mesh.vertex[h + 2]));
+                f->index = (int)_faces.size();
+                _faces.push_back(f);
+            }
+            for (uint32_t h = 0; h < _mesh.twin.size(); ++h) {
+                uint32_t t = _mesh.twin[h];
+                if (t != no_index && t > h) {
+                    connect(_faces[HalfEdgeMesh::face(h)], h % 3, _faces[HalfEdgeMesh::face(t)], t % 3);
+                }
+            }
         }
+        return _faces;
+    }
+};
+
+class VoronoiDiagram {
+    std::vector<Point2*> _sites;
+    SiteAdjacency _adjacency;
+    VoronoiPolygons _polygons;
+    
+    // VoronoiCell2 view of the adjacency, built by the first call to cells()
+    mutable std::vector<VoronoiCell2> _cell_storage;
+    mutable std::vector<uint32_t> _cell_sites;
+    mutable std::vector<VoronoiCell2*> _cells;
+    
+public:
+    // the cells are clipped to the width x height rectangle around the origin
+    VoronoiDiagram(float width, float height, std::vector<Point2*> const& points,
+                   InsertionOrder order = InsertBRIO, int threads = 1) : _sites(points) {
+        DelaunayTriangulation dt(points, order, threads);
+        _adjacency = dt.adjacency();
+        _polygons = dt.voronoi_polygons(Vector2(-0.5f * width, -0.5f * height), Vector2(0.5f * width, 0.5f * height));
+    }
+    
+    SiteAdjacency const& adjacency() const { return _adjacency; }
+    VoronoiPolygons const& polygons() const { return _polygons; }
+    
+    // the position of the cell's point in the points of the diagram
+    uint32_t site(VoronoiCell2 const* cell) const {
+        cells();
+        return _cell_sites[cell - _cell_storage.data()];
     }
     
-    std::vector<VoronoiCell2*> const& cells() const { return _cells; }
+    // a cell for every site with neighbours, in site order
+    std::vector<VoronoiCell2*> const& cells() const {
+        if (_cells.empty()) {
+            std::vector<uint32_t> cell(_sites.size(), no_index);
+            for (uint32_t i = 0; i < _sites.size(); ++i) {
+                if (_adjacency.degree(i) > 0) {
+                    cell[i] = (uint32_t)_cell_storage.size();
+                    _cell_storage.push_back(VoronoiCell2(_sites[i]));
+                    _cell_sites.push_back(i);
+                }
+            }
+            for (uint32_t i = 0; i < _sites.size(); ++i) {
+                if (cell[i] == no_index) continue;
+                VoronoiCell2& c = _cell_storage[cell[i]];
+                c.n.reserve(_adjacency.degree(i));
+                for (uint32_t const* n = _adjacency.begin(i); n != _adjacency.end(i); ++n) {
+                    c.n.push_back(&_cell_storage[cell[*n]]);
+                }
+                _cells.push_back(&c);
+            }
+        }
+        return _cells;
+    }
 };
 
 #endif /* defined(__LD29__DelaunayTriangulation__) */
@@ -7,11 +7,16 @@
 //
 
 #include "Geometry.h"
+#include <algorithm>
+#include <thread>
+#include "Kernels.h"
+#include "Polygon.h"
 
 Face2::Face2(Point2* p0, Point2* p1, Point2* p2)
 : p{p0, p1, p2}, e{{this, 0, 0}, {this, 1, 0}, {this, 2, 0}} {}
 Face2::Face2(Face2 const& f)
 : p{f.p[0], f.p[1], f.p[2]}, e{{this, 0, f.e[0].e}, {this, 1, f.e[1].e}, {this, 2, f.e[2].e}} {}
+// the index stays, the face keeps its place in the face list
 Face2 const& Face2::operator = (Face2 const& f) {
     p[0] = f.p[0];
     p[1] = f.p[1];
@@ -35,12 +40,11 @@ int cw_next(int i) {
 }
 
 bool ccw(Point2* p0, Point2* p1, Point2* p2) {
-    Vector2 d01 = p1->l - p0->l;
-    Vector2 d02 = p2->l - p0->l;
-    if (d01[0] * d02[1] - d01[1] * d02[0] >= 0.0f) {
-        return true;
-    }
-    return false;
+    return ccw(p0->l, p1->l, p2->l);
+}
+
+bool ccw(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2) {
+    return orient2d(p0, p1, p2) >= 0.0;
 }
 
 float area(Point2* p0, Point2* p1, Point2* p2) {
@@ -56,18 +60,28 @@ float area(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2) {
 }
 
 bool in_circle(Point2* p0, Point2* p1, Point2* p2, Point2* p3) {
-    Vector2 u = p0->l;
-    Vector2 v = p1->l;
-    Vector2 p = p2->l;
-    Vector2 q = p3->l;
-    Matrix4 delta(1.0f, u[0], u[1], u[0] * u[0] + u[1] * u[1],
-                  1.0f, v[0], v[1], v[0] * v[0] + v[1] * v[1],
-                  1.0f, p[0], p[1], p[0] * p[0] + p[1] * p[1],
-                  1.0f, q[0], q[1], q[0] * q[0] + q[1] * q[1]);
-    Matrix3 gamma(1.0f, u[0], u[1],
-                  1.0f, v[0], v[1],
-                  1.0f, p[0], p[1]);
-    return det(gamma) * det(delta) < 0.0f;
+    return in_circle(p0->l, p1->l, p2->l, p3->l);
+}
+
+// for either orientation of p0, p1, p2
+bool in_circle(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2, Vector2 const& p3) {
+    double orientation = orient2d(p0, p1, p2);
+    double d = incircle(p0, p1, p2, p3);
+    return orientation > 0.0 ? d > 0.0 : orientation < 0.0 && d < 0.0;
+}
+
+Vector2 circumcenter(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2) {
+    double bx = (double)p1[0] - p0[0];
+    double by = (double)p1[1] - p0[1];
+    double cx = (double)p2[0] - p0[0];
+    double cy = (double)p2[1] - p0[1];
+    double d = 2.0 * (bx * cy - by * cx);
+    if (d == 0.0) {
+        return (p0 + p1 + p2) / 3.0f;
+    }
+    double b_lift = bx * bx + by * by;
+    double c_lift = cx * cx + cy * cy;
+    return Vector2((float)(p0[0] + (cy * b_lift - by * c_lift) / d), (float)(p0[1] + (bx * c_lift - cx * b_lift) / d));
 }
 
 void connect(Face2* f0, int i0, Face2* f1, int i1) {
@@ -120,7 +134,7 @@ void flip(Face2* f0, int i0, Face2* f1, int i1) {
     if (e3) connect(f0, 1, e3->f, e3->i);
 }
 
-void split(Face2* f, Point2* p, Face2** out0, Face2** out1, Face2** out2) {
+void split(Face2* f, Point2* p, Face2** out0, Face2** out1, Face2** out2, Arena<Face2>& arena) {
     Point2* p0 = f->p[0];
     Point2* p1 = f->p[1];
     Point2* p2 = f->p[2];
@@ -128,9 +142,9 @@ void split(Face2* f, Point2* p, Face2** out0, Face2** out1, Face2** out2) {
     Edge2* e1 = f->e[1].e;
     Edge2* e2 = f->e[2].e;
     disconnect(f);
-    *out0 = new Face2(p0, p1, p);
-    *out1 = new Face2(p1, p2, p);
-    *out2 = new Face2(p2, p0, p);
+    *out0 = arena.create(p0, p1, p);
+    *out1 = arena.create(p1, p2, p);
+    *out2 = arena.create(p2, p0, p);
     connect(*out0, 1, *out1, 2);
     connect(*out1, 1, *out2, 2);
     connect(*out2, 1, *out0, 2);
@@ -139,7 +153,7 @@ void split(Face2* f, Point2* p, Face2** out0, Face2** out1, Face2** out2) {
     if (e2) connect(*out2, 0, e2->f, e2->i);
 }
 
-void split_edge(Face2* f, int i, Point2* p, Face2** out0, Face2** out1) {
+void split_edge(Face2* f, int i, Point2* p, Face2** out0, Face2** out1, Arena<Face2>& arena) {
     int i0 = i;
     int i1 = ccw_next(i0);
     int i2 = ccw_next(i1);
@@ -149,8 +163,8 @@ void split_edge(Face2* f, int i, Point2* p, Face2** out0, Face2** out1) {
     Edge2* e1 = f->e[i1].e;
     Edge2* e2 = f->e[i2].e;
     disconnect(f);
-    *out0 = new Face2(p0, p, p2);
-    *out1 = new Face2(p, p1, p2);
+    *out0 = arena.create(p0, p, p2);
+    *out1 = arena.create(p, p1, p2);
     connect(*out0, 1, *out1, 2);
     if (e1) connect(*out1, 1, e1->f, e1->i);
     if (e2) connect(*out0, 2, e2->f, e2->i);
@@ -169,24 +183,196 @@ Point2* support(std::vector<Point2*> const& points, Vector2 const& direction) {
     return result;
 }
 
-std::vector<Point2*> convex_hull(std::vector<Point2*> const& points) {
-    std::vector<Point2*> hull{support(points, Vector2(-1.0f, 0.0f)), support(points, Vector2(1.0f, 0.0f))};
-    int i0 = 0;
-    do {
-        int i1 = i0+1 < hull.size() ? i0+1 : 0;
-        Vector2 n = vector_normal(hull[i1]->l - hull[i0]->l);
-        Vector2 direction = -Vector2(-n[1], n[0]);
-        Point2* s = support(points, direction);
-        if (s != hull[i0] && s != hull[i1]) {
-            hull.insert(hull.begin()+(i0+1), s);
-        } else {
-            i0++;
+std::vector<Point2*> monotone_chain_hull(std::vector<Point2*> const& points) {
+    std::vector<Point2*> sorted(points);
+    std::sort(sorted.begin(), sorted.end(), [](Point2* p0, Point2* p1) {
+        return p0->l[0] < p1->l[0] || (p0->l[0] == p1->l[0] && p0->l[1] < p1->l[1]);
+    });
+    if (sorted.size() < 3) return sorted;
+    
+    // the lower hull from left to right, then the upper hull back, both only
+    // turning left
+    std::vector<Point2*> hull(2 * sorted.size());
+    size_t k = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        while (k >= 2 && orient2d(hull[k - 2]->l, hull[k - 1]->l, sorted[i]->l) <= 0.0) {
+            --k;
         }
-    } while (i0 < hull.size());
+        hull[k++] = sorted[i];
+    }
+    size_t lower = k + 1;
+    for (size_t i = sorted.size() - 1; i-- > 0;) {
+        while (k >= lower && orient2d(hull[k - 2]->l, hull[k - 1]->l, sorted[i]->l) <= 0.0) {
+            --k;
+        }
+        hull[k++] = sorted[i];
+    }
+    hull.resize(k - 1); // the last one is the first one again
     return hull;
 }
 
-std::vector<Face2*> triangulate_convex(std::vector<Point2*> const& hull) {
+// coordinates as separate arrays for batch_extreme_point, with the position
+// of each point in the input
+struct HullPoints {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<uint32_t> index;
+    
+    HullPoints(size_t count) : x(count), y(count), index(count) {}
+    
+    Vector2 location(size_t i) const {
+        return Vector2(x[i], y[i]);
+    }
+    void swap(size_t i0, size_t i1) {
+        std::swap(x[i0], x[i1]);
+        std::swap(y[i0], y[i1]);
+        std::swap(index[i0], index[i1]);
+    }
+};
+
+/*
+ * Adds the hull vertices between a and b to hull, in order; the points from
+ * begin to end are the ones strictly right of a->b. The point c furthest
+ * from a->b is on the hull, the points inside the triangle a, c, b are not,
+ * and the others are moved in place to the front of the range, those right
+ * of a->c first. The furthest point is found in float, so a point that is
+ * only nearly furthest may end up in hull too, but no hull vertex is lost.
+ */
+static void quickhull(Vector2 const& a, Vector2 const& b, HullPoints& points, size_t begin, size_t end, std::vector<uint32_t>& hull) {
+    if (begin == end) return;
+    Vector2 d = b - a;
+    size_t k = begin + batch_extreme_point(points.x.data() + begin, points.y.data() + begin, (int)(end - begin), d[1], -d[0]);
+    points.swap(k, --end);
+    Vector2 c = points.location(end);
+    uint32_t c_index = points.index[end];
+    
+    size_t left_end = begin;
+    for (size_t i = begin; i < end; ++i) {
+        if (orient2d(a, c, points.location(i)) < 0.0) {
+            points.swap(i, left_end++);
+        }
+    }
+    size_t right_end = left_end;
+    for (size_t i = left_end; i < end; ++i) {
+        if (orient2d(c, b, points.location(i)) < 0.0) {
+            points.swap(i, right_end++);
+        }
+    }
+    quickhull(a, c, points, begin, left_end, hull);
+    hull.push_back(c_index);
+    quickhull(c, b, points, left_end, right_end, hull);
+}
+
+// runs work(begin, end, chunk) for chunk_count consecutive ranges of count
+// items, each on its own thread
+template<typename Work>
+static void for_chunks(size_t count, int chunk_count, Work work) {
+    if (chunk_count == 1) {
+        work(0, count, 0);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (int j = 0; j < chunk_count; ++j) {
+        size_t begin = count * j / chunk_count;
+        size_t end = count * (j + 1) / chunk_count;
+        workers.push_back(std::thread([=]() {
+            work(begin, end, j);
+        }));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/*
+ * Quickhull from the leftmost and the rightmost point, on the coordinates in
+ * separate arrays, partitioned in place. With more than one thread the
+ * passes over all points run in chunks, and the lower and the upper half of
+ * the hull are built at the same time. The vertices quickhull found are run
+ * through monotone_chain_hull, which exactly drops the nearly furthest
+ * points that are not on the hull.
+ */
+std::vector<Point2*> convex_hull(std::vector<Point2*> const& points, int threads) {
+    static const size_t min_chunk_size = 32768;
+    size_t n = points.size();
+    if (n < 3) return monotone_chain_hull(points);
+    int chunk_count = (int)std::max((size_t)1, std::min((size_t)std::max(threads, 1), n / min_chunk_size));
+    
+    // the leftmost and the rightmost point of every chunk
+    std::vector<float> x(n);
+    std::vector<float> y(n);
+    std::vector<uint32_t> extremes(2 * chunk_count);
+    for_chunks(n, chunk_count, [&](size_t begin, size_t end, int j) {
+        for (size_t i = begin; i < end; ++i) {
+            x[i] = points[i]->l[0];
+            y[i] = points[i]->l[1];
+        }
+        extremes[2 * j] = (uint32_t)begin + batch_extreme_point(x.data() + begin, y.data() + begin, (int)(end - begin), -1.0f, 0.0f);
+        extremes[2 * j + 1] = (uint32_t)begin + batch_extreme_point(x.data() + begin, y.data() + begin, (int)(end - begin), 1.0f, 0.0f);
+    });
+    uint32_t ia = extremes[0];
+    uint32_t ib = extremes[1];
+    for (int j = 1; j < chunk_count; ++j) {
+        if (x[extremes[2 * j]] < x[ia]) ia = extremes[2 * j];
+        if (x[extremes[2 * j + 1]] > x[ib]) ib = extremes[2 * j + 1];
+    }
+    if (x[ia] == x[ib]) return monotone_chain_hull(points); // on a vertical line
+    Vector2 a(x[ia], y[ia]);
+    Vector2 b(x[ib], y[ib]);
+    
+    // the points below a->b, then the ones above it
+    std::vector<char> side(n);
+    std::vector<size_t> below(chunk_count + 1, 0);
+    std::vector<size_t> above(chunk_count + 1, 0);
+    for_chunks(n, chunk_count, [&](size_t begin, size_t end, int j) {
+        for (size_t i = begin; i < end; ++i) {
+            double o = orient2d(a, b, Vector2(x[i], y[i]));
+            side[i] = o < 0.0 ? -1 : (o > 0.0 ? 1 : 0);
+            below[j + 1] += side[i] < 0;
+            above[j + 1] += side[i] > 0;
+        }
+    });
+    for (int j = 0; j < chunk_count; ++j) {
+        below[j + 1] += below[j];
+        above[j + 1] += above[j];
+    }
+    size_t below_count = below[chunk_count];
+    HullPoints outside(below_count + above[chunk_count]);
+    for_chunks(n, chunk_count, [&](size_t begin, size_t end, int j) {
+        size_t next_below = below[j];
+        size_t next_above = below_count + above[j];
+        for (size_t i = begin; i < end; ++i) {
+            if (side[i] == 0) continue;
+            size_t o = side[i] < 0 ? next_below++ : next_above++;
+            outside.x[o] = x[i];
+            outside.y[o] = y[i];
+            outside.index[o] = (uint32_t)i;
+        }
+    });
+    
+    std::vector<uint32_t> lower{ia};
+    std::vector<uint32_t> upper{ib};
+    if (chunk_count > 1) {
+        std::thread worker([&]() {
+            quickhull(b, a, outside, below_count, outside.index.size(), upper);
+        });
+        quickhull(a, b, outside, 0, below_count, lower);
+        worker.join();
+    } else {
+        quickhull(a, b, outside, 0, below_count, lower);
+        quickhull(b, a, outside, below_count, outside.index.size(), upper);
+    }
+    std::vector<Point2*> candidates;
+    for (uint32_t i : lower) {
+        candidates.push_back(points[i]);
+    }
+    for (uint32_t i : upper) {
+        candidates.push_back(points[i]);
+    }
+    return monotone_chain_hull(candidates);
+}
+
+std::vector<Face2*> triangulate_convex(std::vector<Point2*> const& hull, Arena<Face2>& arena) {
     std::vector<Face2*> result;
     std::vector<Point2*> sub_hull = hull;
     std::vector<Face2*> neighbours(hull.size(), 0);
@@ -195,7 +381,7 @@ std::vector<Face2*> triangulate_convex(std::vector<Point2*> const& hull) {
             int i1 = i0+1 < sub_hull.size() ? i0+1 : 0;
             int i2 = i1+1 < sub_hull.size() ? i1+1 : 0;
             if (area(sub_hull[i0], sub_hull[i1], sub_hull[i2]) > 0.0f) {
-                result.push_back(new Face2(sub_hull[i0], sub_hull[i1], sub_hull[i2]));
+                result.push_back(arena.create(sub_hull[i0], sub_hull[i1], sub_hull[i2]));
                 if (neighbours[i0]) connect(result.back(), 0, neighbours[i0], 2);
                 if (neighbours[i1]) connect(result.back(), 1, neighbours[i1], 2);
                 neighbours[i0] = result.back();
@@ -205,7 +391,7 @@ std::vector<Face2*> triangulate_convex(std::vector<Point2*> const& hull) {
             }
         }
     }
-    result.push_back(new Face2(sub_hull[0], sub_hull[1], sub_hull[2]));
+    result.push_back(arena.create(sub_hull[0], sub_hull[1], sub_hull[2]));
     if (neighbours[0]) connect(result.back(), 0, neighbours[0], 2);
     if (neighbours[1]) connect(result.back(), 1, neighbours[1], 2);
     if (neighbours[2]) connect(result.back(), 2, neighbours[2], 2);
@@ -222,6 +408,75 @@ std::vector<Vector3> vertex_data(std::vector<Face2*> const faces) {
     return vertices;
 }
 
+uint32_t hilbert_index(uint32_t x, uint32_t y) {
+    const uint32_t n = 1 << 16;
+    uint32_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // rotate the quadrant so the curve continues
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+std::vector<uint32_t> brio_permutation(std::vector<Point2*> const& points, RandomStream& random) {
+    if (points.empty()) {
+        return std::vector<uint32_t>();
+    }
+    Vector2 lower = points[0]->l;
+    Vector2 upper = points[0]->l;
+    for (Point2* p : points) {
+        lower = Vector2(std::min(lower[0], p->l[0]), std::min(lower[1], p->l[1]));
+        upper = Vector2(std::max(upper[0], p->l[0]), std::max(upper[1], p->l[1]));
+    }
+    float extent = std::max(upper[0] - lower[0], upper[1] - lower[1]);
+    float scale = extent > 0.0f ? 65535.0f / extent : 0.0f;
+    
+    // every point lands in the last round with probability 1/2, in the one
+    // before with 1/4 and so on; rounds are inserted first to last
+    struct Key {
+        uint64_t key;
+        uint32_t i;
+    };
+    std::vector<Key> keys(points.size());
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        uint32_t bits = random();
+        uint32_t round = 0;
+        while ((bits & 1) && round < 31) {
+            bits >>= 1;
+            round++;
+        }
+        uint32_t x = (uint32_t)((points[i]->l[0] - lower[0]) * scale);
+        uint32_t y = (uint32_t)((points[i]->l[1] - lower[1]) * scale);
+        keys[i].key = ((uint64_t)(31 - round) << 32) | hilbert_index(x, y);
+        keys[i].i = i;
+    }
+    std::sort(keys.begin(), keys.end(), [](Key const& a, Key const& b) { return a.key < b.key; });
+    
+    std::vector<uint32_t> result(points.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        result[i] = keys[i].i;
+    }
+    return result;
+}
+
+std::vector<Point2*> brio_order(std::vector<Point2*> const& points, RandomStream& random) {
+    std::vector<uint32_t> permutation = brio_permutation(points, random);
+    std::vector<Point2*> result(points.size());
+    for (size_t i = 0; i < permutation.size(); ++i) {
+        result[i] = points[permutation[i]];
+    }
+    return result;
+}
+
 bool intersection(Vector2 const& p0, Vector2 const& n0, Vector2 const& p1, Vector2 const& n1, Vector2& result) {
     Vector2 vs(-n1[1], n1[0]);
     Vector2 w = p0 - p1;
@@ -252,143 +507,49 @@ bool segment_intersection(Vector2 const& p0, Vector2 const& p1, Vector2 const& q
 
 std::vector<Vector2> cut(std::vector<Vector2> const& a, std::vector<Vector2> const& b) {
     std::vector<Vector2> result;
-    std::vector<Vector2> br = b;
-    std::reverse(br.begin(), br.end());
-    
-    struct Intersection {
-        Vector2 pos;
-        bool start;
-        int i0;
-        int i1;
-        int j0;
-        int j1;
-    };
-    std::vector<Intersection> intersections;
-    
-    for (int i0 = 0; i0 < a.size(); ++i0) {
-        int i1 = i0+1 < a.size() ? i0+1 : 0;
-        for (int j0 = 0; j0 < br.size(); ++j0) {
-            int j1 = j0+1 < br.size() ? j0+1 : 0;
-            
-            Intersection inter;
-            inter.i0 = i0;
-            inter.i1 = i1;
-            inter.j0 = j0;
-            inter.j1 = j1;
-            if (segment_intersection(a[i0], a[i1], br[j0], br[j1], inter.pos, true)) {
-                inter.start = area(a[i0], a[i1], br[j0]) < 0.0f;
-                intersections.push_back(inter);
-            }
-        }
-    }
-    
-    if (intersections.size() > 0) {
-        if (intersections[0].start == false) {
-            intersections.push_back(intersections.front());
-            intersections.erase(intersections.begin());
-        }
-        
-        
-    } else {
-        int i = 0;
-        int j = 0;
-        bool found = false;
-        for (i = 0; i < a.size(); ++i) {
-            for (j = 0; j < br.size(); ++j) {
-                // is this a valid cut?
-                bool valid = true;
-                Vector2 n = vector_normal(a[i] - br[j]);
-                for (Vector2 const& p : br) {
-                    if (dot(n, p - br[j]) > 0.0f) {
-                        valid = false;
-                        break;
-                    }
-                }
-                if (!valid) {
-                    continue;
-                }
-                for (int k0 = 0; k0 < a.size(); ++k0) {
-                    int k1 = k0+1 < a.size() ? k0+1 : 0;
-                    
-                    if (k0 != i && k1 != i) {
-                        Vector2 tmp;
-                        
-                        if (segment_intersection(br[j], a[i], a[k0], a[k1], tmp, true)) {
-                            valid = false;
-                            break;
-                        }
-                    }
-                }
-                if (valid) {
-                    found = true;
-                    break;
-                }
-            }
-            if (found) {
-                break;
-            }
+    double result_area = 0.0;
+    for (std::vector<Vector2> const& polygon : join_holes(polygon_boolean({a}, {b}, PolygonDifference))) {
+        double polygon_area = 0.0;
+        for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+            polygon_area += (double)polygon[j][0] * polygon[i][1] - (double)polygon[i][0] * polygon[j][1];
         }
-        
-        if (found) {
-            result = std::vector<Vector2>(a.begin(), a.begin()+i+1);
-            result.insert(result.end(), br.begin()+j, br.end());
-            result.insert(result.end(), br.begin(), br.begin()+j+1);
-            result.insert(result.end(), a.begin()+i, a.end());
+        if (polygon_area > result_area) {
+            result = polygon;
+            result_area = polygon_area;
         }
     }
-    
     return result;
 }
 
 std::vector<Vector2> triangulate(std::vector<Vector2> const& points) {
     std::vector<Vector2> triangulation;
-    if (points.size() < 3) return triangulation;
-    std::vector<Vector2> remaining = points;
-    while (remaining.size() > 3) {
-        for (int i0 = 0; i0 < remaining.size(); ++i0) {
-            int i1 = i0+1 < remaining.size() ? i0+1 : 0;
-            int i2 = i1+1 < remaining.size() ? i1+1 : 0;
-            if (area(remaining[i0], remaining[i1], remaining[i2]) > 0.0f) {
-                //std::cout << remaining.size() << std::endl;
-                //std::cout << i0 << " " << i1 << " " << i2 << std::endl;
-                bool valid = true;
-                for (int j0 = 0; j0 < remaining.size(); ++j0) {
-                    int j1 = j0+1 < remaining.size() ? j0+1 : 0;
-                    Vector2 tmp;
-                    if (segment_intersection(remaining[i0], remaining[i2],
-                                             remaining[j0], remaining[j1], tmp)) {
-                        valid = false;
-                        break;
-                    }
-                }
-                if (valid) {
-                    //std::cout << "create" << std::endl;
-                    triangulation.push_back(remaining[i0]);
-                    triangulation.push_back(remaining[i1]);
-                    triangulation.push_back(remaining[i2]);
-                    remaining.erase(remaining.begin()+i1);
-                    
-                    /*if (remaining.size() == 23) {
-                        std::cout << "remaining:" << std::endl;
-                        for (Vector2 const& p : remaining) {
-                            std::cout << p << std::endl;
-                        }
-                        return triangulation;
-                    }*/
-                    
-                    break;
-                }
-            }
-        }
+    for (uint32_t i : triangulate_polygon(points)) {
+        triangulation.push_back(points[i]);
     }
-    triangulation.push_back(remaining[0]);
-    triangulation.push_back(remaining[1]);
-    triangulation.push_back(remaining[2]);
     return triangulation;
 }
 
+constexpr Vector2 unit_circle_point(int i, int d) {
+    return Vector2(constant_cos(2.0 * PI * i / d), constant_sin(2.0 * PI * i / d));
+}
+
+// the resolution all the shapes use, computed at compile time
+static constexpr Vector2 unit_circle_16[] = {
+    unit_circle_point(0, 16),  unit_circle_point(1, 16),  unit_circle_point(2, 16),  unit_circle_point(3, 16),
+    unit_circle_point(4, 16),  unit_circle_point(5, 16),  unit_circle_point(6, 16),  unit_circle_point(7, 16),
+    unit_circle_point(8, 16),  unit_circle_point(9, 16),  unit_circle_point(10, 16), unit_circle_point(11, 16),
+    unit_circle_point(12, 16), unit_circle_point(13, 16), unit_circle_point(14, 16), unit_circle_point(15, 16)
+};
+
 std::vector<Vector2> circle(Vector2 center, float r, int d) {
     std::vector<Vector2> points;
+    points.reserve(std::max(3, d));
+    if (d == 16) {
+        for (const Vector2& p : unit_circle_16) {
+            points.push_back(center + r * p);
+        }
+        return points;
+    }
     float dt = 2.0f * PI / (float)std::max(3, d);
     for (int i = 0; i < std::max(3, d); ++i) {
         points.push_back(center + Vector2(r * cosf(i * dt), r * sinf(i * dt)));
@@ -434,3 +595,41 @@ std::vector<Vector3> voronoi_cell_mesh(float width, float height, VoronoiCell2*
     
     return result;
 }
+
+std::vector<Vector3> convex_polygon_mesh(Vector2 const* begin, Vector2 const* end, float inset) {
+    std::vector<Vector3> result;
+    std::vector<Vector2> convex(begin, end);
+    std::vector<Vector2> clipped;
+    int count = (int)(end - begin);
+    if (inset != 0.0f) {
+        for (int i0 = 0; i0 < count; ++i0) {
+            Vector2 const& o = begin[i0];
+            Vector2 d = begin[i0+1 < count ? i0+1 : 0] - o;
+            // the direction of a tiny edge is mostly rounding error, and moving
+            // it in changes next to nothing
+            if (squared_length(d) < inset * inset) continue;
+            Vector2 n = vector_normal(Vector2(-d[1], d[0]));
+            clipped.clear();
+            for (int j0 = 0; j0 < convex.size(); ++j0) {
+                int j1 = j0+1 < convex.size() ? j0+1 : 0;
+                float s0 = dot(n, convex[j0] - o) - inset;
+                float s1 = dot(n, convex[j1] - o) - inset;
+                if (s0 >= 0.0f) {
+                    clipped.push_back(convex[j0]);
+                }
+                if ((s0 >= 0.0f) != (s1 >= 0.0f)) {
+                    clipped.push_back(convex[j0] + (s0 / (s0 - s1)) * (convex[j1] - convex[j0]));
+                }
+            }
+            convex.swap(clipped);
+        }
+    }
+    
+    for (int i = 1; i < (int)convex.size()-1; ++i) {
+        result.push_back(Vector3(convex[0][0], 0.0f, convex[0][1]));
+        result.push_back(Vector3(convex[i][0], 0.0f, convex[i][1]));
+        result.push_back(Vector3(convex[i+1][0], 0.0f, convex[i+1][1]));
+    }
+    
+    return result;
+}
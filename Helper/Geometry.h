@@ -13,6 +13,8 @@
 
 #include <vector>
 #include "Types.h"
+#include "Arena.h"
+#include "Predicates.h"
 
 struct Edge2;
 
@@ -38,6 +40,7 @@ struct Face2 {
 
     Point2* p[3]; // corners
     Edge2 e[3]; // edges
+    int index = -1; // position in the owning face list, kept by assignment
 }; // Face2
 
 struct VoronoiCell2 {
@@ -52,29 +55,52 @@ int ccw_next(int i);
 // next index in clockwise direction
 int cw_next(int i);
 bool ccw(Point2* p0, Point2* p1, Point2* p2);
+bool ccw(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2);
 float area(Point2* p0, Point2* p1, Point2* p2);
 float area(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2);
 bool in_circle(Point2* p0, Point2* p1, Point2* p2, Point2* p3);
+bool in_circle(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2, Vector2 const& p3);
+Vector2 circumcenter(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2);
 void connect(Face2* f0, int i0, Face2* f1, int i1);
 void disconnect(Face2* f);
 void disconnect(Face2* f, int i);
 Face2* neighbour(Face2* f, int i);
 void flip(Face2* f0, int i0, Face2* f1, int i1);
-void split(Face2* f, Point2* p, Face2** out0, Face2** out1, Face2** out2);
-void split_edge(Face2* f, int i, Point2* p, Face2** out0, Face2** out1);
+// the new faces come from arena, f is left to the caller
+void split(Face2* f, Point2* p, Face2** out0, Face2** out1, Face2** out2, Arena<Face2>& arena);
+void split_edge(Face2* f, int i, Point2* p, Face2** out0, Face2** out1, Arena<Face2>& arena);
 
 Point2* support(std::vector<Point2*> const& points, Vector2 const& direction);
-std::vector<Point2*> convex_hull(std::vector<Point2*> const& points);
-std::vector<Face2*> triangulate_convex(std::vector<Point2*> const& hull);
+// Andrew's monotone chain, O(n log n) for any input
+std::vector<Point2*> monotone_chain_hull(std::vector<Point2*> const& points);
+// Both return the hull counter clockwise from the lowest of the leftmost
+// points, without points on its edges. convex_hull is quickhull, faster for
+// the usual inputs, see Geometry.cpp.
+std::vector<Point2*> convex_hull(std::vector<Point2*> const& points, int threads = 1);
+std::vector<Face2*> triangulate_convex(std::vector<Point2*> const& hull, Arena<Face2>& arena);
 std::vector<Vector3> vertex_data(std::vector<Face2*> const faces);
 
+// position of (x, y) along a Hilbert curve through the 2^16 x 2^16 grid
+uint32_t hilbert_index(uint32_t x, uint32_t y);
+// biased randomized insertion order: rounds that double in size, each sorted
+// along a Hilbert curve over the bounding box of the points
+std::vector<Point2*> brio_order(std::vector<Point2*> const& points, RandomStream& random);
+// the same as positions in points
+std::vector<uint32_t> brio_permutation(std::vector<Point2*> const& points, RandomStream& random);
+
 bool intersection(Vector2 const& p0, Vector2 const& n0, Vector2 const& p1, Vector2 const& n1, Vector2& result);
 bool segment_intersection(Vector2 const& p0, Vector2 const& p1, Vector2 const& q0, Vector2 const& q1, Vector2& result, bool incl = false);
+// a without b, the largest piece if b splits it, with holes joined in by
+// bridges; see polygon_boolean
 std::vector<Vector2> cut(std::vector<Vector2> const& a, std::vector<Vector2> const& b);
+// triangles of the polygon, three corners each, see triangulate_polygon
 std::vector<Vector2> triangulate(std::vector<Vector2> const& points);
 
 std::vector<Vector2> circle(Vector2 center, float r, int d);
 
 std::vector<Vector3> voronoi_cell_mesh(float width, float height, VoronoiCell2* cell);
+// triangles of a fan over the counter clockwise convex polygon, with every
+// edge moved inwards by inset
+std::vector<Vector3> convex_polygon_mesh(Vector2 const* begin, Vector2 const* end, float inset);
 
 #endif /* defined(__LD29__Geometry__) */
@@ -0,0 +1,134 @@
+//
+//  HalfEdgeMesh.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "HalfEdgeMesh.h"
+
+uint32_t HalfEdgeMesh::add_face(uint32_t v0, uint32_t v1, uint32_t v2) {
+    uint32_t h = (uint32_t)vertex.size();
+    vertex.push_back(v0);
+    vertex.push_back(v1);
+    vertex.push_back(v2);
+    twin.resize(h + 3, no_index);
+    return h;
+}
+
+void HalfEdgeMesh::link(uint32_t h0, uint32_t h1) {
+    twin[h0] = h1;
+    if (h1 != no_index) {
+        twin[h1] = h0;
+    }
+}
+
+// a0 = p->q, a1 = q->r, a2 = r->p and b0 = q->p, b1 = p->s, b2 = s->q become
+// a0 = s->r, a1 = r->p, a2 = p->s and b0 = r->s, b1 = s->q, b2 = q->r
+uint32_t HalfEdgeMesh::flip(uint32_t h) {
+    uint32_t a0 = h;
+    uint32_t a1 = next(a0);
+    uint32_t a2 = next(a1);
+    uint32_t b0 = twin[h];
+    uint32_t b1 = next(b0);
+    uint32_t b2 = next(b1);
+
+    uint32_t p = vertex[a0];
+    uint32_t q = vertex[a1];
+    uint32_t r = vertex[a2];
+    uint32_t s = vertex[b2];
+
+    uint32_t ta1 = twin[a1];
+    uint32_t ta2 = twin[a2];
+    uint32_t tb1 = twin[b1];
+    uint32_t tb2 = twin[b2];
+
+    vertex[a0] = s;
+    vertex[a1] = r;
+    vertex[a2] = p;
+    vertex[b0] = r;
+    vertex[b1] = s;
+    vertex[b2] = q;
+
+    link(a0, b0);
+    link(a1, ta2);
+    link(a2, tb1);
+    link(b1, tb2);
+    link(b2, ta1);
+    return a0;
+}
+
+// a, b, c becomes a, b, v in f and b, c, v and c, a, v in new faces
+void HalfEdgeMesh::split(uint32_t f, uint32_t v, uint32_t opposite[3]) {
+    uint32_t h0 = 3 * f;
+    uint32_t a = vertex[h0];
+    uint32_t b = vertex[h0 + 1];
+    uint32_t c = vertex[h0 + 2];
+    uint32_t t1 = twin[h0 + 1];
+    uint32_t t2 = twin[h0 + 2];
+
+    vertex[h0 + 2] = v;
+    uint32_t g0 = add_face(b, c, v);
+    uint32_t k0 = add_face(c, a, v);
+
+    link(g0, t1);
+    link(k0, t2);
+    link(h0 + 1, g0 + 2);
+    link(g0 + 1, k0 + 2);
+    link(k0 + 1, h0 + 2);
+
+    opposite[0] = h0;
+    opposite[1] = g0;
+    opposite[2] = k0;
+}
+
+// a->b in a, b, c and b->a in b, a, d become a, v, c and v, b, c as well as
+// b, v, d and v, a, d
+int HalfEdgeMesh::split_edge(uint32_t h, uint32_t v, uint32_t opposite[4]) {
+    uint32_t a0 = h;
+    uint32_t a1 = next(a0);
+    uint32_t a2 = next(a1);
+    uint32_t b = vertex[a1];
+    uint32_t c = vertex[a2];
+    uint32_t ta1 = twin[a1];
+
+    vertex[a1] = v;
+    uint32_t g0 = add_face(v, b, c);
+    link(g0 + 1, ta1);
+    link(g0 + 2, a1);
+    opposite[0] = a2;
+    opposite[1] = g0 + 1;
+
+    uint32_t b0 = twin[h];
+    if (b0 == no_index) {
+        return 2;
+    }
+    uint32_t b1 = next(b0);
+    uint32_t b2 = next(b1);
+    uint32_t a = vertex[b1];
+    uint32_t d = vertex[b2];
+    uint32_t tb1 = twin[b1];
+
+    vertex[b1] = v;
+    uint32_t k0 = add_face(v, a, d);
+    link(k0 + 1, tb1);
+    link(k0 + 2, b1);
+    link(a0, k0);
+    link(b0, g0);
+    opposite[2] = b2;
+    opposite[3] = k0 + 1;
+    return 4;
+}
+
+void HalfEdgeMesh::remove_face(uint32_t f) {
+    uint32_t last = face_count() - 1;
+    if (f != last) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            vertex[3 * f + i] = vertex[3 * last + i];
+            twin[3 * f + i] = no_index;
+            link(3 * f + i, twin[3 * last + i]);
+        }
+    }
+    vertex.resize(3 * last);
+    twin.resize(3 * last);
+}
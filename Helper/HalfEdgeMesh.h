@@ -0,0 +1,74 @@
+//
+//  HalfEdgeMesh.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __LD29__HalfEdgeMesh__
+#define __LD29__HalfEdgeMesh__
+
+#include <stdint.h>
+#include <vector>
+
+static const uint32_t no_index = 0xFFFFFFFF;
+
+/*
+ * A triangle mesh as half edges in contiguous arrays of 32 bit indices.
+ * Face f owns the half edges 3f, 3f+1 and 3f+2 in counter clockwise order,
+ * so the next half edge and the face of a half edge are computed, and only
+ * the start vertex and the opposite half edge (twin) are stored: 8 bytes per
+ * half edge instead of a 60 byte Face2 per face. Half edge 3f+i corresponds
+ * to edge i of a Face2, from p[i] to p[i+1].
+ */
+struct HalfEdgeMesh {
+    std::vector<uint32_t> vertex; // vertex[h]: where h starts
+    std::vector<uint32_t> twin; // twin[h]: the opposite half edge, no_index on the boundary
+
+    static uint32_t face(uint32_t h) {
+        return h / 3;
+    }
+    static uint32_t next(uint32_t h) {
+        return h % 3 == 2 ? h - 2 : h + 1;
+    }
+    static uint32_t previous(uint32_t h) {
+        return h % 3 == 0 ? h + 2 : h - 1;
+    }
+
+    uint32_t face_count() const {
+        return (uint32_t)vertex.size() / 3;
+    }
+
+    // the face v0, v1, v2 without neighbours, returns its first half edge
+    uint32_t add_face(uint32_t v0, uint32_t v1, uint32_t v2);
+    void link(uint32_t h0, uint32_t h1);
+
+    /*
+     * Replaces the edge h between the faces of h and twin[h] by the other
+     * diagonal of their quad. Both faces keep their slots. Returns the half
+     * edge of the new diagonal in the face of h; the face of h now starts at
+     * the vertex opposite h in the twin face.
+     */
+    uint32_t flip(uint32_t h);
+
+    /*
+     * Splits face f at vertex v into three faces, f keeps the first one. The
+     * three half edges opposite v are returned in opposite.
+     */
+    void split(uint32_t f, uint32_t v, uint32_t opposite[3]);
+
+    /*
+     * Splits the edge h (and its twin) at vertex v, which lies on it. Returns
+     * the number of half edges opposite v written to opposite, two on the
+     * boundary and four inside.
+     */
+    int split_edge(uint32_t h, uint32_t v, uint32_t opposite[4]);
+
+    /*
+     * Removes face f by moving the last face into its slot, so only the last
+     * face changes its index. No other face may still be linked to f.
+     */
+    void remove_face(uint32_t f);
+};
+
+#endif /* defined(__LD29__HalfEdgeMesh__) */
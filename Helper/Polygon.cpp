@@ -0,0 +1,1217 @@
+//
+//  Polygon.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "Polygon.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <set>
+#include "Arena.h"
+#include "MathUtility.h"
+#include "Predicates.h"
+
+static const uint32_t no_node = 0xFFFFFFFF;
+
+// a vertex of the polygon still to triangulate, in a ring through prev and next
+struct PolygonNode {
+    Vector2 p;
+    uint32_t i; // position in the input
+    uint32_t prev;
+    uint32_t next;
+    uint32_t z = 0;
+    uint32_t prev_convex = no_node; // in the ring of the convex vertices
+    uint32_t next_convex = no_node;
+    bool removed = false;
+};
+
+static int sign(double x) {
+    return (x > 0.0) - (x < 0.0);
+}
+
+// q inside the bounding box of p and r, for q collinear with them
+static bool on_segment(Vector2 const& p, Vector2 const& q, Vector2 const& r) {
+    return q[0] <= std::max(p[0], r[0]) && q[0] >= std::min(p[0], r[0]) &&
+           q[1] <= std::max(p[1], r[1]) && q[1] >= std::min(p[1], r[1]);
+}
+
+// do the segments p0->p1 and q0->q1 intersect or touch?
+static bool intersects(Vector2 const& p0, Vector2 const& p1, Vector2 const& q0, Vector2 const& q1) {
+    int o0 = sign(orient2d(p0, p1, q0));
+    int o1 = sign(orient2d(p0, p1, q1));
+    int o2 = sign(orient2d(q0, q1, p0));
+    int o3 = sign(orient2d(q0, q1, p1));
+    if (o0 != o1 && o2 != o3) return true;
+    if (o0 == 0 && on_segment(p0, q0, p1)) return true;
+    if (o1 == 0 && on_segment(p0, q1, p1)) return true;
+    if (o2 == 0 && on_segment(q0, p0, q1)) return true;
+    if (o3 == 0 && on_segment(q0, p1, q1)) return true;
+    return false;
+}
+
+// p inside or on the triangle a, b, c, in either orientation
+static bool in_triangle(Vector2 const& a, Vector2 const& b, Vector2 const& c, Vector2 const& p) {
+    double o0 = orient2d(a, b, p);
+    double o1 = orient2d(b, c, p);
+    double o2 = orient2d(c, a, p);
+    return (o0 >= 0.0 && o1 >= 0.0 && o2 >= 0.0) || (o0 <= 0.0 && o1 <= 0.0 && o2 <= 0.0);
+}
+
+// p inside or on the counter clockwise triangle a, b, c, but not at a
+static bool in_triangle_except_a(Vector2 const& a, Vector2 const& b, Vector2 const& c, Vector2 const& p) {
+    if (p[0] == a[0] && p[1] == a[1]) return false;
+    return orient2d(a, b, p) >= 0.0 && orient2d(b, c, p) >= 0.0 && orient2d(c, a, p) >= 0.0;
+}
+
+/*
+ * Mapbox's earcut on a single ring, with exact predicates. When no ear is
+ * left, the ring is cleaned of repeated and collinear points, then small
+ * self intersections are cut off as triangles, and as a last resort it is
+ * split along a diagonal into two rings that are triangulated separately.
+ *
+ * A reflex vertex is never an ear, so the search only walks the convex
+ * vertices, which are linked in a ring of their own. Along a concave stretch
+ * the vertices turn convex one by one as their neighbours are clipped, and
+ * walking past all of them on every lap made smooth wavy outlines quadratic.
+ *
+ * Only a reflex vertex can be inside an ear, and clipping ears never makes
+ * a vertex reflex, so the index holds the reflex vertices of the ring, sorted
+ * by z when a pass starts. Removed vertices are left in it until they are
+ * half of it, vertices that became convex fail the test in blocks().
+ */
+struct EarClipping {
+    std::vector<PolygonNode> nodes;
+    std::vector<uint32_t> triangles;
+    bool hashed = false;
+    Vector2 lower;
+    float scale = 0.0f; // maps the bounding box to [0, 32767]
+    std::vector<uint64_t> reflex_keys; // z << 32 | node, sorted, so a search reads no nodes
+    size_t removed_reflex = 0;
+
+    uint32_t add_node(uint32_t i, Vector2 const& p, uint32_t last);
+    uint32_t add_ring(std::vector<Vector2> const& points, bool counter_clockwise);
+    void remove_node(uint32_t n);
+    bool equal(uint32_t a, uint32_t b) const;
+    double orient(uint32_t a, uint32_t b, uint32_t c) const;
+    bool reflex(uint32_t n) const;
+
+    uint32_t z_order(Vector2 const& p) const;
+    void index_reflex(uint32_t start);
+    uint32_t link_convex(uint32_t start);
+    void insert_convex(uint32_t n, uint32_t after);
+    uint32_t remove_convex(uint32_t n);
+    uint32_t filter_points(uint32_t start, uint32_t end = no_node);
+    bool is_ear(uint32_t ear) const;
+    bool is_ear_hashed(uint32_t ear) const;
+    bool blocks(uint32_t n, uint32_t a, uint32_t b, uint32_t c, Vector2 const& lower, Vector2 const& upper) const;
+
+    bool locally_inside(uint32_t a, uint32_t b) const;
+    bool middle_inside(uint32_t a, uint32_t b) const;
+    bool intersects_polygon(uint32_t a, uint32_t b) const;
+    bool is_valid_diagonal(uint32_t a, uint32_t b) const;
+    uint32_t split_polygon(uint32_t a, uint32_t b);
+
+    uint32_t cure_local_intersections(uint32_t start);
+    void split_ear_clipping(uint32_t start);
+    void clip_ears(uint32_t ear, int pass);
+
+    uint32_t leftmost(uint32_t start) const;
+    bool sector_contains_sector(uint32_t m, uint32_t p) const;
+    uint32_t find_hole_bridge(uint32_t hole, uint32_t outline) const;
+    uint32_t eliminate_hole(uint32_t hole, uint32_t outline);
+};
+
+// twice the signed area, > 0 for counter clockwise points
+static double signed_area(std::vector<Vector2> const& points) {
+    double area = 0.0;
+    for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+        area += ((double)points[j][0] - points[i][0]) * ((double)points[j][1] + points[i][1]);
+    }
+    return area;
+}
+
+// a node after last in the ring, or a new ring
+uint32_t EarClipping::add_node(uint32_t i, Vector2 const& p, uint32_t last) {
+    uint32_t n = (uint32_t)nodes.size();
+    PolygonNode node;
+    node.p = p;
+    node.i = i;
+    if (last == no_node) {
+        node.prev = n;
+        node.next = n;
+    } else {
+        node.prev = last;
+        node.next = nodes[last].next;
+        nodes[nodes[last].next].prev = n;
+        nodes[last].next = n;
+    }
+    nodes.push_back(node);
+    return n;
+}
+
+// links points as a new ring in the given orientation, returns its last node;
+// i counts on from the nodes already there
+uint32_t EarClipping::add_ring(std::vector<Vector2> const& points, bool counter_clockwise) {
+    uint32_t offset = (uint32_t)nodes.size();
+    bool reverse = (signed_area(points) >= 0.0) != counter_clockwise;
+    uint32_t last = no_node;
+    for (size_t k = 0; k < points.size(); ++k) {
+        uint32_t i = (uint32_t)(reverse ? points.size() - 1 - k : k);
+        last = add_node(offset + i, points[i], last);
+    }
+    if (equal(last, nodes[last].next)) {
+        uint32_t next = nodes[last].next;
+        remove_node(last);
+        last = next;
+    }
+    return last;
+}
+
+void EarClipping::remove_node(uint32_t n) {
+    PolygonNode& node = nodes[n];
+    nodes[node.next].prev = node.prev;
+    nodes[node.prev].next = node.next;
+    node.removed = true;
+    if (hashed && node.z != no_node && ++removed_reflex > reflex_keys.size() / 2) {
+        reflex_keys.erase(std::remove_if(reflex_keys.begin(), reflex_keys.end(), [this](uint64_t key) { return nodes[(uint32_t)key].removed; }), reflex_keys.end());
+        removed_reflex = 0;
+    }
+}
+
+bool EarClipping::equal(uint32_t a, uint32_t b) const {
+    return nodes[a].p[0] == nodes[b].p[0] && nodes[a].p[1] == nodes[b].p[1];
+}
+
+double EarClipping::orient(uint32_t a, uint32_t b, uint32_t c) const {
+    return orient2d(nodes[a].p, nodes[b].p, nodes[c].p);
+}
+
+// reflex or collinear, where the ring turns right or goes straight on
+bool EarClipping::reflex(uint32_t n) const {
+    return orient(nodes[n].prev, n, nodes[n].next) <= 0.0;
+}
+
+// the 15 bit grid coordinates, interleaved; unlike hilbert_index, the keys of
+// all points in a box are between the keys of its corners
+uint32_t EarClipping::z_order(Vector2 const& p) const {
+    uint32_t x = (uint32_t)((p[0] - lower[0]) * scale);
+    uint32_t y = (uint32_t)((p[1] - lower[1]) * scale);
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    y = (y | (y << 8)) & 0x00FF00FF;
+    y = (y | (y << 4)) & 0x0F0F0F0F;
+    y = (y | (y << 2)) & 0x33333333;
+    y = (y | (y << 1)) & 0x55555555;
+    return x | (y << 1);
+}
+
+// the reflex vertices of the ring from start, z is no_node for the others
+void EarClipping::index_reflex(uint32_t start) {
+    reflex_keys.clear();
+    removed_reflex = 0;
+    uint32_t n = start;
+    do {
+        if (reflex(n)) {
+            nodes[n].z = z_order(nodes[n].p);
+            reflex_keys.push_back((uint64_t)nodes[n].z << 32 | n);
+        } else {
+            nodes[n].z = no_node;
+        }
+        n = nodes[n].next;
+    } while (n != start);
+    std::sort(reflex_keys.begin(), reflex_keys.end());
+}
+
+// links the convex vertices of the ring from start, returns the first one
+// from start on, or no_node if there is none
+uint32_t EarClipping::link_convex(uint32_t start) {
+    uint32_t first = no_node;
+    uint32_t last = no_node;
+    uint32_t n = start;
+    do {
+        if (reflex(n)) {
+            nodes[n].prev_convex = no_node;
+            nodes[n].next_convex = no_node;
+        } else if (first == no_node) {
+            first = last = n;
+            nodes[n].prev_convex = n;
+            nodes[n].next_convex = n;
+        } else {
+            insert_convex(n, last);
+            last = n;
+        }
+        n = nodes[n].next;
+    } while (n != start);
+    return first;
+}
+
+void EarClipping::insert_convex(uint32_t n, uint32_t after) {
+    nodes[n].prev_convex = after;
+    nodes[n].next_convex = nodes[after].next_convex;
+    nodes[nodes[after].next_convex].prev_convex = n;
+    nodes[after].next_convex = n;
+}
+
+// returns the convex vertex after n, or no_node if n was the last
+uint32_t EarClipping::remove_convex(uint32_t n) {
+    uint32_t next = nodes[n].next_convex;
+    nodes[nodes[n].prev_convex].next_convex = next;
+    nodes[next].prev_convex = nodes[n].prev_convex;
+    nodes[n].prev_convex = no_node;
+    nodes[n].next_convex = no_node;
+    return next != n ? next : no_node;
+}
+
+// removes repeated points and collinear vertices from start until end,
+// returns a node still in the ring
+uint32_t EarClipping::filter_points(uint32_t start, uint32_t end) {
+    if (end == no_node) end = start;
+    uint32_t n = start;
+    bool again;
+    do {
+        again = false;
+        if (equal(n, nodes[n].next) || orient(nodes[n].prev, n, nodes[n].next) == 0.0) {
+            remove_node(n);
+            n = end = nodes[n].prev;
+            if (n == nodes[n].next) break;
+            again = true;
+        } else {
+            n = nodes[n].next;
+        }
+    } while (again || n != end);
+    return end;
+}
+
+// is the reflex vertex n in the ear a, b, c with bounding box lower, upper?
+bool EarClipping::blocks(uint32_t n, uint32_t a, uint32_t b, uint32_t c, Vector2 const& lower, Vector2 const& upper) const {
+    Vector2 const& p = nodes[n].p;
+    return n != a && n != c &&
+           p[0] >= lower[0] && p[0] <= upper[0] && p[1] >= lower[1] && p[1] <= upper[1] &&
+           in_triangle_except_a(nodes[a].p, nodes[b].p, nodes[c].p, p) && reflex(n);
+}
+
+bool EarClipping::is_ear(uint32_t ear) const {
+    uint32_t a = nodes[ear].prev;
+    uint32_t c = nodes[ear].next;
+    if (reflex(ear)) return false;
+    Vector2 const& pa = nodes[a].p;
+    Vector2 const& pb = nodes[ear].p;
+    Vector2 const& pc = nodes[c].p;
+    Vector2 lower(std::min(pa[0], std::min(pb[0], pc[0])), std::min(pa[1], std::min(pb[1], pc[1])));
+    Vector2 upper(std::max(pa[0], std::max(pb[0], pc[0])), std::max(pa[1], std::max(pb[1], pc[1])));
+    for (uint32_t n = nodes[c].next; n != a; n = nodes[n].next) {
+        if (blocks(n, a, ear, c, lower, upper)) return false;
+    }
+    return true;
+}
+
+static const uint32_t z_even = 0x55555555; // the x bits of a z-order key
+static const uint32_t z_odd = 0xAAAAAAAA; // the y bits
+
+// is z in the box of the keys min_z and max_z, not just between them?
+static bool z_in_box(uint32_t z, uint32_t min_z, uint32_t max_z) {
+    return (z & z_even) >= (min_z & z_even) && (z & z_even) <= (max_z & z_even) &&
+           (z & z_odd) >= (min_z & z_odd) && (z & z_odd) <= (max_z & z_odd);
+}
+
+/*
+ * The smallest key after z in the box of min_z and max_z, for z between
+ * them but outside the box (Tropf and Herzog's BIGMIN): from the highest bit
+ * down, where z leaves the box the search goes on in the half of the box
+ * above it.
+ */
+static uint32_t z_next_in_box(uint32_t z, uint32_t min_z, uint32_t max_z) {
+    uint32_t result = max_z;
+    for (int k = 29; k >= 0; --k) {
+        uint32_t bit = 1u << k;
+        uint32_t below = (k % 2 == 0 ? z_even : z_odd) & (bit - 1); // the lower bits of the same axis
+        bool in_z = (z & bit) != 0;
+        bool in_min = (min_z & bit) != 0;
+        bool in_max = (max_z & bit) != 0;
+        if (!in_z && !in_min && in_max) {
+            // the box is split here, z is in its lower half
+            result = (min_z & ~below) | bit;
+            max_z = (max_z & ~(below | bit)) | below;
+        } else if (!in_z && in_min) {
+            return min_z; // the whole box is above z
+        } else if (in_z && !in_max) {
+            return result; // the box is below z from here on
+        } else if (in_z && !in_min) {
+            min_z = (min_z & ~below) | bit;
+        }
+    }
+    return result;
+}
+
+// the same, but only looks at the indexed vertices in the z-order box of
+// the ear's bounding box
+bool EarClipping::is_ear_hashed(uint32_t ear) const {
+    uint32_t a = nodes[ear].prev;
+    uint32_t c = nodes[ear].next;
+    if (reflex(ear)) return false;
+    Vector2 const& pa = nodes[a].p;
+    Vector2 const& pb = nodes[ear].p;
+    Vector2 const& pc = nodes[c].p;
+    Vector2 lower(std::min(pa[0], std::min(pb[0], pc[0])), std::min(pa[1], std::min(pb[1], pc[1])));
+    Vector2 upper(std::max(pa[0], std::max(pb[0], pc[0])), std::max(pa[1], std::max(pb[1], pc[1])));
+    uint32_t min_z = z_order(lower);
+    uint32_t max_z = z_order(upper);
+
+    std::vector<uint64_t>::const_iterator r = std::lower_bound(reflex_keys.begin(), reflex_keys.end(), (uint64_t)min_z << 32);
+    while (r != reflex_keys.end() && (uint32_t)(*r >> 32) <= max_z) {
+        uint32_t z = (uint32_t)(*r >> 32);
+        if (!z_in_box(z, min_z, max_z)) {
+            // the keys between the corners of a box leave it and come back
+            r = std::lower_bound(r, reflex_keys.end(), (uint64_t)z_next_in_box(z, min_z, max_z) << 32);
+            continue;
+        }
+        uint32_t n = (uint32_t)*r;
+        if (!nodes[n].removed && blocks(n, a, ear, c, lower, upper)) return false;
+        ++r;
+    }
+    return true;
+}
+
+// does the diagonal a->b start into the polygon at a?
+bool EarClipping::locally_inside(uint32_t a, uint32_t b) const {
+    uint32_t prev = nodes[a].prev;
+    uint32_t next = nodes[a].next;
+    if (orient(prev, a, next) > 0.0) {
+        return orient(a, b, next) <= 0.0 && orient(a, prev, b) <= 0.0;
+    }
+    return orient(a, b, prev) > 0.0 || orient(a, next, b) > 0.0;
+}
+
+// is the middle of a->b inside the polygon, by the crossings of a ray to +x?
+bool EarClipping::middle_inside(uint32_t a, uint32_t b) const {
+    bool inside = false;
+    float x = (nodes[a].p[0] + nodes[b].p[0]) * 0.5f;
+    float y = (nodes[a].p[1] + nodes[b].p[1]) * 0.5f;
+    uint32_t n = a;
+    do {
+        Vector2 const& p0 = nodes[n].p;
+        Vector2 const& p1 = nodes[nodes[n].next].p;
+        if ((p0[1] > y) != (p1[1] > y) && p1[1] != p0[1] &&
+            x < (p1[0] - p0[0]) * (y - p0[1]) / (p1[1] - p0[1]) + p0[0]) {
+            inside = !inside;
+        }
+        n = nodes[n].next;
+    } while (n != a);
+    return inside;
+}
+
+// does a->b cross an edge of the polygon that does not end at a or b?
+bool EarClipping::intersects_polygon(uint32_t a, uint32_t b) const {
+    uint32_t n = a;
+    do {
+        uint32_t next = nodes[n].next;
+        if (nodes[n].i != nodes[a].i && nodes[next].i != nodes[a].i &&
+            nodes[n].i != nodes[b].i && nodes[next].i != nodes[b].i &&
+            intersects(nodes[n].p, nodes[next].p, nodes[a].p, nodes[b].p)) {
+            return true;
+        }
+        n = next;
+    } while (n != a);
+    return false;
+}
+
+bool EarClipping::is_valid_diagonal(uint32_t a, uint32_t b) const {
+    if (nodes[nodes[a].next].i == nodes[b].i || nodes[nodes[a].prev].i == nodes[b].i) return false;
+    if (intersects_polygon(a, b)) return false;
+    if (locally_inside(a, b) && locally_inside(b, a) && middle_inside(a, b) &&
+        (orient(nodes[a].prev, a, nodes[b].prev) != 0.0 || orient(a, nodes[b].prev, b) != 0.0)) {
+        return true;
+    }
+    // a bridge end point, where both sides turn left
+    return equal(a, b) && orient(nodes[a].prev, a, nodes[a].next) > 0.0 && orient(nodes[b].prev, b, nodes[b].next) > 0.0;
+}
+
+// cuts the ring along a->b into a->b->...->a and a copy of b->...->a->b,
+// returns the copy of b
+uint32_t EarClipping::split_polygon(uint32_t a, uint32_t b) {
+    uint32_t a2 = add_node(nodes[a].i, nodes[a].p, no_node);
+    uint32_t b2 = add_node(nodes[b].i, nodes[b].p, no_node);
+    uint32_t an = nodes[a].next;
+    uint32_t bp = nodes[b].prev;
+
+    nodes[a].next = b;
+    nodes[b].prev = a;
+    nodes[a2].next = an;
+    nodes[an].prev = a2;
+    nodes[b2].next = a2;
+    nodes[a2].prev = b2;
+    nodes[bp].next = b2;
+    nodes[b2].prev = bp;
+    return b2;
+}
+
+// where the edges before and after two consecutive vertices cross, the
+// triangle they enclose is cut off
+uint32_t EarClipping::cure_local_intersections(uint32_t start) {
+    uint32_t n = start;
+    do {
+        uint32_t a = nodes[n].prev;
+        uint32_t b = nodes[nodes[n].next].next;
+        if (!equal(a, b) && intersects(nodes[a].p, nodes[n].p, nodes[nodes[n].next].p, nodes[b].p) &&
+            locally_inside(a, b) && locally_inside(b, a)) {
+            triangles.push_back(nodes[a].i);
+            triangles.push_back(nodes[n].i);
+            triangles.push_back(nodes[b].i);
+            remove_node(nodes[n].next);
+            remove_node(n);
+            n = start = b;
+        }
+        n = nodes[n].next;
+    } while (n != start);
+    return filter_points(n);
+}
+
+void EarClipping::split_ear_clipping(uint32_t start) {
+    uint32_t a = start;
+    do {
+        for (uint32_t b = nodes[nodes[a].next].next; b != nodes[a].prev; b = nodes[b].next) {
+            if (nodes[a].i != nodes[b].i && is_valid_diagonal(a, b)) {
+                uint32_t c = split_polygon(a, b);
+                a = filter_points(a, nodes[a].next);
+                c = filter_points(c, nodes[c].next);
+                clip_ears(a, 0);
+                clip_ears(c, 0);
+                return;
+            }
+        }
+        a = nodes[a].next;
+    } while (a != start);
+}
+
+/*
+ * Clips the ears of the ring from ear. Pass 0 finds the ears of a simple
+ * polygon; the later passes, one after another, only run once no ear is
+ * left. They can make vertices reflex, so every pass indexes them again.
+ */
+void EarClipping::clip_ears(uint32_t ear, int pass) {
+    if (hashed) index_reflex(ear);
+    uint32_t from = ear; // where the last lap started, the next pass starts there
+    ear = link_convex(ear);
+    uint32_t stop = ear;
+    while (ear != no_node && nodes[ear].prev != nodes[ear].next) {
+        uint32_t prev = nodes[ear].prev;
+        uint32_t next = nodes[ear].next;
+        if (hashed ? is_ear_hashed(ear) : is_ear(ear)) {
+            triangles.push_back(nodes[prev].i);
+            triangles.push_back(nodes[ear].i);
+            triangles.push_back(nodes[next].i);
+            remove_node(ear);
+            // clipping never makes a vertex reflex, but can make one convex
+            if (nodes[prev].next_convex == no_node && !reflex(prev)) insert_convex(prev, nodes[ear].prev_convex);
+            if (nodes[next].next_convex == no_node && !reflex(next)) insert_convex(next, ear);
+            uint32_t following = remove_convex(ear);
+            // skipping the next vertex gives fewer sliver triangles
+            ear = following == next ? nodes[next].next_convex : following;
+            from = nodes[next].next;
+            stop = ear;
+            continue;
+        }
+        ear = nodes[ear].next_convex;
+        if (ear == stop) break;
+    }
+    if (nodes[from].prev == nodes[from].next) return;
+    if (pass == 0) {
+        clip_ears(filter_points(from), 1);
+    } else if (pass == 1) {
+        clip_ears(cure_local_intersections(filter_points(from)), 2);
+    } else {
+        split_ear_clipping(from);
+    }
+}
+
+// the lowest of the leftmost vertices of the ring
+uint32_t EarClipping::leftmost(uint32_t start) const {
+    uint32_t result = start;
+    uint32_t n = start;
+    do {
+        Vector2 const& p = nodes[n].p;
+        Vector2 const& q = nodes[result].p;
+        if (p[0] < q[0] || (p[0] == q[0] && p[1] < q[1])) {
+            result = n;
+        }
+        n = nodes[n].next;
+    } while (n != start);
+    return result;
+}
+
+// does the sector of m contain the sector of p, both at the same point?
+bool EarClipping::sector_contains_sector(uint32_t m, uint32_t p) const {
+    return orient(nodes[m].prev, m, nodes[p].prev) > 0.0 && orient(nodes[p].next, m, nodes[m].next) > 0.0;
+}
+
+/*
+ * The vertex of the outline that the leftmost vertex of a hole is joined to:
+ * the end of the closest edge to the left, along a ray to -x, or of the
+ * vertices in the triangle between the hole, the hit and that end, the one
+ * with the smallest angle to the ray, which the hole can see.
+ */
+uint32_t EarClipping::find_hole_bridge(uint32_t hole, uint32_t outline) const {
+    Vector2 const& h = nodes[hole].p;
+    double qx = -std::numeric_limits<double>::infinity();
+    uint32_t m = no_node;
+    uint32_t n = outline;
+    if (equal(hole, n)) return n;
+    do {
+        uint32_t next = nodes[n].next;
+        if (equal(hole, next)) return next;
+        Vector2 const& p0 = nodes[n].p;
+        Vector2 const& p1 = nodes[next].p;
+        // the edges that go down on the left of a counter clockwise outline
+        if (h[1] <= p0[1] && h[1] >= p1[1] && p1[1] != p0[1]) {
+            double x = p0[0] + ((double)h[1] - p0[1]) * ((double)p1[0] - p0[0]) / ((double)p1[1] - p0[1]);
+            if (x <= h[0] && x > qx) {
+                qx = x;
+                m = p0[0] < p1[0] ? n : next;
+                if (x == h[0]) return m; // the hole touches the edge
+            }
+        }
+        n = next;
+    } while (n != outline);
+    if (m == no_node) return no_node;
+
+    uint32_t stop = m;
+    Vector2 mp = nodes[m].p;
+    Vector2 q((float)qx, h[1]);
+    double tan_min = std::numeric_limits<double>::infinity();
+    n = m;
+    do {
+        Vector2 const& p = nodes[n].p;
+        if (h[0] >= p[0] && p[0] >= mp[0] && h[0] != p[0] &&
+            in_triangle(h[1] < mp[1] ? h : q, mp, h[1] < mp[1] ? q : h, p)) {
+            double tan = std::fabs((double)h[1] - p[1]) / ((double)h[0] - p[0]);
+            if (locally_inside(n, hole) &&
+                (tan < tan_min || (tan == tan_min && (p[0] > nodes[m].p[0] || (p[0] == nodes[m].p[0] && sector_contains_sector(m, n)))))) {
+                m = n;
+                tan_min = tan;
+            }
+        }
+        n = nodes[n].next;
+    } while (n != stop);
+    return m;
+}
+
+// joins the hole to the outline by a bridge, returns a node of the outline
+uint32_t EarClipping::eliminate_hole(uint32_t hole, uint32_t outline) {
+    uint32_t bridge = find_hole_bridge(hole, outline);
+    if (bridge == no_node) return outline;
+    uint32_t bridge_reverse = split_polygon(bridge, hole);
+    filter_points(bridge_reverse, nodes[bridge_reverse].next);
+    return filter_points(bridge, nodes[bridge].next);
+}
+
+std::vector<uint32_t> triangulate_polygon(std::vector<Vector2> const& points) {
+    EarClipping clipping;
+    if (points.size() < 3) return clipping.triangles;
+    clipping.nodes.reserve(points.size() + points.size() / 8);
+    uint32_t last = clipping.add_ring(points, true);
+
+    if (points.size() > 80) {
+        Vector2 lower = points[0];
+        Vector2 upper = points[0];
+        for (Vector2 const& p : points) {
+            lower = Vector2(std::min(lower[0], p[0]), std::min(lower[1], p[1]));
+            upper = Vector2(std::max(upper[0], p[0]), std::max(upper[1], p[1]));
+        }
+        float size = std::max(upper[0] - lower[0], upper[1] - lower[1]);
+        if (size > 0.0f) {
+            clipping.hashed = true;
+            clipping.lower = lower;
+            clipping.scale = 32767.0f / size;
+        }
+    }
+    clipping.clip_ears(last, 0);
+    return clipping.triangles;
+}
+
+std::vector<std::vector<Vector2>> join_holes(std::vector<std::vector<Vector2>> const& rings) {
+    std::vector<std::vector<Vector2>> result;
+    size_t r = 0;
+    while (r < rings.size()) {
+        if (rings[r].size() < 3) {
+            ++r;
+            continue;
+        }
+        EarClipping joining;
+        uint32_t outline = joining.add_ring(rings[r], true);
+        std::vector<uint32_t> holes;
+        for (++r; r < rings.size() && signed_area(rings[r]) < 0.0; ++r) {
+            if (rings[r].size() >= 3) {
+                holes.push_back(joining.leftmost(joining.add_ring(rings[r], false)));
+            }
+        }
+        // from left to right, so a hole can be joined to the bridge of another
+        std::sort(holes.begin(), holes.end(), [&joining](uint32_t a, uint32_t b) {
+            Vector2 const& p = joining.nodes[a].p;
+            Vector2 const& q = joining.nodes[b].p;
+            return p[0] < q[0] || (p[0] == q[0] && p[1] < q[1]);
+        });
+        for (uint32_t hole : holes) {
+            outline = joining.eliminate_hole(hole, outline);
+        }
+        
+        std::vector<Vector2> polygon;
+        uint32_t n = outline;
+        do {
+            polygon.push_back(joining.nodes[n].p);
+            n = joining.nodes[n].next;
+        } while (n != outline);
+        result.push_back(polygon);
+    }
+    return result;
+}
+
+typedef enum {
+    EdgeNormal,
+    EdgeNonContributing,        // overlaps an edge of the other polygon, which stands for both
+    EdgeSameTransition,         // overlaps one with the inside on the same side
+    EdgeDifferentTransition     // overlaps one with the inside on the other side
+} EdgeType;
+
+struct SweepEvent;
+
+// the order of the edges that cross the sweep line, from bottom to top
+struct SegmentOrder {
+    bool operator () (SweepEvent const* e0, SweepEvent const* e1) const;
+};
+
+typedef std::set<SweepEvent*, SegmentOrder> SweepStatus;
+
+// an end point of an edge
+struct SweepEvent {
+    Vector2 p;
+    SweepEvent* other; // the other end
+    uint32_t edge; // orders the events of equal edges
+    bool left; // the edge goes from here to the right
+    bool subject; // from a, not from b
+    EdgeType type;
+    bool in_out; // does a ray up from below end outside of its polygon after this edge?
+    bool other_in_out; // is the ray outside of the other polygon?
+    int result_transition; // the ray goes into (1) or out of (-1) the result, 0 if not a result edge
+    SweepEvent* prev_in_result; // the closest result edge below
+    bool in_status;
+    bool rounded; // made by splitting an edge, maybe off its line
+    SweepStatus::iterator position;
+    int contour; // of the result
+    int other_position; // of the other end in the result events
+
+    SweepEvent(Vector2 const& p, bool left, SweepEvent* other, bool subject, uint32_t edge)
+    : p(p), other(other), edge(edge), left(left), subject(subject), type(EdgeNormal), in_out(false), other_in_out(false),
+      result_transition(0), prev_in_result(nullptr), in_status(false), rounded(false), contour(-1), other_position(-1) {}
+
+    bool in_result() const {
+        return result_transition != 0;
+    }
+    bool vertical() const {
+        return p[0] == other->p[0];
+    }
+    // is the edge below q?
+    bool below(Vector2 const& q) const {
+        return left ? orient2d(p, other->p, q) > 0.0 : orient2d(other->p, p, q) > 0.0;
+    }
+};
+
+static bool same_point(Vector2 const& p, Vector2 const& q) {
+    return p[0] == q[0] && p[1] == q[1];
+}
+
+// is e0 processed after e1? From left to right, and bottom to top, right
+// ends before left ends at the same point, lower edges first.
+static bool processed_after(SweepEvent const* e0, SweepEvent const* e1) {
+    if (e0->p[0] != e1->p[0]) return e0->p[0] > e1->p[0];
+    if (e0->p[1] != e1->p[1]) return e0->p[1] > e1->p[1];
+    if (e0->left != e1->left) return e0->left;
+    if (orient2d(e0->p, e0->other->p, e1->other->p) != 0.0) return !e0->below(e1->other->p);
+    if (e0->subject != e1->subject) return !e0->subject;
+    return e0->edge > e1->edge;
+}
+
+struct EventOrder {
+    bool operator () (SweepEvent const* e0, SweepEvent const* e1) const {
+        return processed_after(e0, e1);
+    }
+};
+
+typedef std::priority_queue<SweepEvent*, std::vector<SweepEvent*>, EventOrder> EventQueue;
+
+bool SegmentOrder::operator () (SweepEvent const* e0, SweepEvent const* e1) const {
+    if (e0 == e1) return false;
+    if (orient2d(e0->p, e0->other->p, e1->p) != 0.0 || orient2d(e0->p, e0->other->p, e1->other->p) != 0.0) {
+        if (same_point(e0->p, e1->p)) return e0->below(e1->other->p);
+        if (e0->p[0] == e1->p[0]) return e0->p[1] < e1->p[1];
+        // compare where the edge inserted later starts, or where it goes if
+        // it starts on the other, which is about to be split there
+        if (processed_after(e0, e1)) {
+            if (orient2d(e1->p, e1->other->p, e0->p) == 0.0) return !e1->below(e0->other->p);
+            return !e1->below(e0->p);
+        }
+        if (orient2d(e0->p, e0->other->p, e1->p) == 0.0) return e0->below(e1->other->p);
+        return e0->below(e1->p);
+    }
+    // collinear
+    if (e0->subject != e1->subject) return e0->subject;
+    return !processed_after(e0, e1);
+}
+
+/*
+ * orient2d of q to the edge of e, but zero for q a few ulps off the line when
+ * one of the points is a rounded crossing: split edges bend a little there,
+ * and a point that was on one has to stay on it. Between input points it is
+ * exact, however close to collinear they are.
+ */
+static double orient_rounded(SweepEvent const* e, SweepEvent const* q) {
+    Vector2 const& p0 = e->p;
+    Vector2 const& p1 = e->other->p;
+    double o = orient2d(p0, p1, q->p);
+    if (!e->rounded && !e->other->rounded && !q->rounded) return o;
+    // moving a point by its rounding error d changes o by up to
+    // |d.x| * |extent y| + |d.y| * |extent x|
+    Vector2 scale(0.0f, 0.0f);
+    Vector2 extent(0.0f, 0.0f);
+    for (Vector2 const* p : {&p0, &p1, &q->p}) {
+        for (int k = 0; k < 2; ++k) {
+            scale[k] = std::max(scale[k], std::fabs((*p)[k]));
+            extent[k] = std::max(extent[k], std::fabs((*p)[k] - p0[k]));
+        }
+    }
+    double tolerance = 8.0 * std::numeric_limits<float>::epsilon() * ((double)scale[0] * extent[1] + (double)scale[1] * extent[0]);
+    return std::fabs(o) <= tolerance ? 0.0 : o;
+}
+
+/*
+ * The points where the edges of the left ends a and b meet: none, one, or for
+ * overlapping collinear edges two, which are not returned.
+ */
+static int intersection(SweepEvent const* a, SweepEvent const* b, Vector2& result) {
+    Vector2 const& a0 = a->p;
+    Vector2 const& a1 = a->other->p;
+    Vector2 const& b0 = b->p;
+    Vector2 const& b1 = b->other->p;
+    double o0 = orient_rounded(a, b);
+    double o1 = orient_rounded(a, b->other);
+    if ((o0 > 0.0 && o1 > 0.0) || (o0 < 0.0 && o1 < 0.0)) return 0;
+    double o2 = orient_rounded(b, a);
+    double o3 = orient_rounded(b, a->other);
+    if ((o2 > 0.0 && o3 > 0.0) || (o2 < 0.0 && o3 < 0.0)) return 0;
+    if (o0 == 0.0 && o1 == 0.0) {
+        // along the axis a is longer in
+        int k = std::fabs(a1[0] - a0[0]) >= std::fabs(a1[1] - a0[1]) ? 0 : 1;
+        float lower = std::max(std::min(a0[k], a1[k]), std::min(b0[k], b1[k]));
+        float upper = std::min(std::max(a0[k], a1[k]), std::max(b0[k], b1[k]));
+        if (lower > upper) return 0;
+        if (lower < upper) return 2;
+        for (Vector2 const* p : {&a0, &a1, &b0, &b1}) {
+            if ((*p)[k] == lower) result = *p;
+        }
+        return 1;
+    }
+    if (o0 == 0.0) {
+        result = b0;
+    } else if (o1 == 0.0) {
+        result = b1;
+    } else if (o2 == 0.0) {
+        result = a0;
+    } else if (o3 == 0.0) {
+        result = a1;
+    } else {
+        double t = o2 / (o2 - o3);
+        result = Vector2((float)(a0[0] + t * ((double)a1[0] - a0[0])), (float)(a0[1] + t * ((double)a1[1] - a0[1])));
+        // a crossing a few ulps off an end is taken to be at the end, instead of
+        // splitting off an edge too short to order, each coordinate within a few
+        // of its own ulps so the other edge does not bend more than rounding would
+        for (Vector2 const* p : {&a0, &a1, &b0, &b1}) {
+            float tolerance_x = 4.0f * std::numeric_limits<float>::epsilon() * std::fabs((*p)[0]);
+            float tolerance_y = 4.0f * std::numeric_limits<float>::epsilon() * std::fabs((*p)[1]);
+            if (std::fabs(result[0] - (*p)[0]) <= tolerance_x && std::fabs(result[1] - (*p)[1]) <= tolerance_y) {
+                result = *p;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+/*
+ * Martinez, Rueda and Feito, "A simple algorithm for Boolean operations on
+ * polygons" (2013). A sweep line from left to right splits the edges where
+ * they cross and keeps the edges that cross it in order, so each edge knows
+ * whether it is inside the other polygon from the edge below it. The result
+ * edges are then joined into rings, and the rings below tell outlines from
+ * holes.
+ */
+struct PolygonSweep {
+    PolygonOperation operation;
+    Arena<SweepEvent> events;
+    EventQueue queue;
+    SweepStatus status;
+    std::vector<SweepEvent*> processed;
+    uint32_t edge_count = 0;
+
+    void add_edges(std::vector<std::vector<Vector2>> const& rings, bool subject);
+    void divide(SweepEvent* e, Vector2 const& p);
+    int possible_intersection(SweepEvent* e0, SweepEvent* e1);
+    bool in_result(SweepEvent const* e) const;
+    void compute_fields(SweepEvent* e, SweepEvent* prev);
+    void sweep(float right_bound);
+    std::vector<std::vector<Vector2>> connect_edges();
+};
+
+/*
+ * Queues the edges of the rings, but an edge that is in them twice cancels
+ * out, like the bridges cut() joins holes with: the inside is what an odd
+ * number of rings encloses.
+ */
+void PolygonSweep::add_edges(std::vector<std::vector<Vector2>> const& rings, bool subject) {
+    std::vector<std::pair<Vector2, Vector2>> edges;
+    for (std::vector<Vector2> const& ring : rings) {
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+            Vector2 p = ring[j];
+            Vector2 q = ring[i];
+            if (same_point(p, q)) continue;
+            if (q[0] < p[0] || (q[0] == p[0] && q[1] < p[1])) std::swap(p, q);
+            edges.push_back(std::make_pair(p, q));
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](std::pair<Vector2, Vector2> const& e0, std::pair<Vector2, Vector2> const& e1) {
+        for (int k = 0; k < 2; ++k) {
+            if (e0.first[k] != e1.first[k]) return e0.first[k] < e1.first[k];
+        }
+        for (int k = 0; k < 2; ++k) {
+            if (e0.second[k] != e1.second[k]) return e0.second[k] < e1.second[k];
+        }
+        return false;
+    });
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && same_point(edges[j].first, edges[i].first) && same_point(edges[j].second, edges[i].second)) {
+            ++j;
+        }
+        if ((j - i) % 2 == 1) {
+            SweepEvent* left = events.create(edges[i].first, true, nullptr, subject, edge_count);
+            SweepEvent* right = events.create(edges[i].second, false, left, subject, edge_count);
+            left->other = right;
+            ++edge_count;
+            queue.push(left);
+            queue.push(right);
+        }
+        i = j;
+    }
+}
+
+// splits the edge of the left end e at p
+void PolygonSweep::divide(SweepEvent* e, Vector2 const& p) {
+    SweepEvent* r = events.create(p, false, e, e->subject, e->edge);
+    SweepEvent* l = events.create(p, true, e->other, e->subject, e->edge);
+    r->rounded = true;
+    l->rounded = true;
+    // rounding p can turn the right part around
+    if (processed_after(l, e->other)) {
+        e->other->left = true;
+        l->left = false;
+    }
+    e->other->other = l;
+    e->other = r;
+    queue.push(l);
+    queue.push(r);
+}
+
+// 0 if the edges do not cross, 1 if they do, 2 if they share their left end
+// and overlap, 3 if they overlap otherwise
+int PolygonSweep::possible_intersection(SweepEvent* e0, SweepEvent* e1) {
+    Vector2 p;
+    int count = intersection(e0, e1, p);
+    if (count == 0) return 0;
+    if (count == 1 && (same_point(e0->p, e1->p) || same_point(e0->other->p, e1->other->p))) return 0;
+    // overlapping edges of the same polygon are left as they are
+    if (count == 2 && e0->subject == e1->subject) return 0;
+    if (count == 1) {
+        if (!same_point(e0->p, p) && !same_point(e0->other->p, p)) divide(e0, p);
+        if (!same_point(e1->p, p) && !same_point(e1->other->p, p)) divide(e1, p);
+        return 1;
+    }
+
+    // the ends of the overlapping edges in sweep order
+    std::vector<SweepEvent*> ends;
+    bool left_coincide = same_point(e0->p, e1->p);
+    bool right_coincide = same_point(e0->other->p, e1->other->p);
+    if (!left_coincide) {
+        if (processed_after(e0, e1)) {
+            ends.push_back(e1);
+            ends.push_back(e0);
+        } else {
+            ends.push_back(e0);
+            ends.push_back(e1);
+        }
+    }
+    if (!right_coincide) {
+        if (processed_after(e0->other, e1->other)) {
+            ends.push_back(e1->other);
+            ends.push_back(e0->other);
+        } else {
+            ends.push_back(e0->other);
+            ends.push_back(e1->other);
+        }
+    }
+    if (left_coincide) {
+        // one of the two edges stands for both
+        e1->type = EdgeNonContributing;
+        e0->type = e1->in_out == e0->in_out ? EdgeSameTransition : EdgeDifferentTransition;
+        if (!right_coincide) divide(ends[1]->other, ends[0]->p);
+        return 2;
+    }
+    if (right_coincide) {
+        divide(ends[0], ends[1]->p);
+        return 3;
+    }
+    if (ends[0] != ends[3]->other) {
+        // neither contains the other
+        divide(ends[0], ends[1]->p);
+        divide(ends[1], ends[2]->p);
+        return 3;
+    }
+    // one contains the other
+    divide(ends[0], ends[1]->p);
+    divide(ends[3]->other, ends[2]->p);
+    return 3;
+}
+
+bool PolygonSweep::in_result(SweepEvent const* e) const {
+    switch (e->type) {
+        case EdgeNormal:
+            switch (operation) {
+                case PolygonDifference: return e->subject == e->other_in_out;
+                case PolygonUnion: return e->other_in_out;
+                case PolygonIntersection: return !e->other_in_out;
+            }
+            return false;
+        case EdgeSameTransition: return operation != PolygonDifference;
+        case EdgeDifferentTransition: return operation == PolygonDifference;
+        case EdgeNonContributing: return false;
+    }
+    return false;
+}
+
+// the flags of the left end e from those of the edge below it
+void PolygonSweep::compute_fields(SweepEvent* e, SweepEvent* prev) {
+    if (prev == nullptr) {
+        e->in_out = false;
+        e->other_in_out = true;
+        e->prev_in_result = nullptr;
+    } else {
+        if (e->subject == prev->subject) {
+            e->in_out = !prev->in_out;
+            e->other_in_out = prev->other_in_out;
+        } else {
+            e->in_out = !prev->other_in_out;
+            e->other_in_out = prev->vertical() ? !prev->in_out : prev->in_out;
+        }
+        e->prev_in_result = (!in_result(prev) || prev->vertical()) ? prev->prev_in_result : prev;
+    }
+    if (!in_result(e)) {
+        e->result_transition = 0;
+        return;
+    }
+    // does the ray go into the result above e?
+    bool inside = !e->in_out;
+    bool other_inside = !e->other_in_out;
+    bool into = false;
+    if (e->type == EdgeSameTransition) {
+        // the other polygon changes along with this one
+        into = inside;
+    } else if (e->type == EdgeDifferentTransition) {
+        // the other polygon changes the other way, only a difference keeps these
+        into = e->subject == inside;
+    } else {
+        switch (operation) {
+            case PolygonDifference: into = e->subject ? inside && !other_inside : other_inside && !inside; break;
+            case PolygonUnion: into = inside || other_inside; break;
+            case PolygonIntersection: into = inside && other_inside; break;
+        }
+    }
+    e->result_transition = into ? 1 : -1;
+}
+
+// processes the events up to right_bound, after which no edge is in the result
+void PolygonSweep::sweep(float right_bound) {
+    while (!queue.empty()) {
+        SweepEvent* e = queue.top();
+        queue.pop();
+        processed.push_back(e);
+        if (e->p[0] > right_bound) break;
+        if (e->left) {
+            e->position = status.insert(e).first;
+            e->in_status = true;
+            SweepStatus::iterator next = std::next(e->position);
+            SweepEvent* prev = e->position != status.begin() ? *std::prev(e->position) : nullptr;
+            compute_fields(e, prev);
+            if (next != status.end() && possible_intersection(e, *next) == 2) {
+                compute_fields(e, prev);
+                compute_fields(*next, e);
+            }
+            if (prev != nullptr && possible_intersection(prev, e) == 2) {
+                SweepStatus::iterator below = prev->position;
+                SweepEvent* prev_prev = below != status.begin() ? *std::prev(below) : nullptr;
+                compute_fields(prev, prev_prev);
+                compute_fields(e, prev);
+            }
+            // a neighbour split where e starts, after rounding, ends there, so
+            // e goes back into the queue to come after that end
+            if ((next != status.end() && same_point((*next)->other->p, e->p)) || (prev != nullptr && same_point(prev->other->p, e->p))) {
+                status.erase(e->position);
+                e->in_status = false;
+                processed.pop_back();
+                queue.push(e);
+            }
+        } else {
+            SweepEvent* left = e->other;
+            if (!left->in_status) continue;
+            SweepStatus::iterator next = std::next(left->position);
+            SweepEvent* prev = left->position != status.begin() ? *std::prev(left->position) : nullptr;
+            status.erase(left->position);
+            left->in_status = false;
+            if (prev != nullptr && next != status.end()) {
+                possible_intersection(prev, *next);
+            }
+        }
+    }
+}
+
+/*
+ * Follows the result edges from end to end into rings. Outlines come out
+ * counter clockwise, each followed by its holes, clockwise.
+ */
+std::vector<std::vector<Vector2>> PolygonSweep::connect_edges() {
+    std::vector<SweepEvent*> result;
+    for (SweepEvent* e : processed) {
+        if ((e->left && e->in_result()) || (!e->left && e->other->in_result())) {
+            result.push_back(e);
+        }
+    }
+    // splitting overlapping edges can leave the ends slightly out of order
+    for (size_t i = 1; i < result.size(); ++i) {
+        for (size_t j = i; j > 0 && processed_after(result[j - 1], result[j]); --j) {
+            std::swap(result[j - 1], result[j]);
+        }
+    }
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i]->other_position = (int)i;
+    }
+    for (SweepEvent* e : result) {
+        if (!e->left) std::swap(e->other_position, e->other->other_position);
+    }
+
+    struct Contour {
+        std::vector<Vector2> points;
+        int hole_of;
+        std::vector<int> holes;
+    };
+    std::vector<Contour> contours;
+    std::vector<bool> done(result.size(), false);
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (done[i]) continue;
+        int id = (int)contours.size();
+        Contour contour;
+        contour.hole_of = -1;
+        // the closest result edge below tells whether this is a hole; one
+        // that left the result when an overlap was found is passed over
+        SweepEvent const* below = result[i]->prev_in_result;
+        while (below != nullptr && below->contour < 0) {
+            below = below->prev_in_result;
+        }
+        if (below != nullptr && below->result_transition > 0) {
+            int parent = contours[below->contour].hole_of >= 0 ? contours[below->contour].hole_of : below->contour;
+            contour.hole_of = parent;
+            contours[parent].holes.push_back(id);
+        }
+
+        // the first end is the lowest left end of the ring, never on a
+        // vertical edge, so its transition tells which side the result is on
+        bool result_left = result[i]->result_transition > 0;
+        int position = (int)i;
+        contour.points.push_back(result[i]->p);
+        while (true) {
+            done[position] = true;
+            result[position]->contour = id;
+            position = result[position]->other_position;
+            done[position] = true;
+            result[position]->contour = id;
+            contour.points.push_back(result[position]->p);
+            if (same_point(result[position]->p, result[i]->p)) break;
+            // where several edges meet, the one next to the edge back around
+            // the result, so rings that touch are not crossed
+            Vector2 const& p = result[position]->p;
+            Vector2 const& q = result[position]->other->p;
+            double back_x = (double)q[0] - p[0];
+            double back_y = (double)q[1] - p[1];
+            int first = position;
+            while (first > 0 && same_point(result[first - 1]->p, p)) --first;
+            int next = -1;
+            double best = 0.0;
+            for (int j = first; j < (int)result.size() && same_point(result[j]->p, p); ++j) {
+                if (done[j]) continue;
+                Vector2 const& r = result[j]->other->p;
+                double x = (double)r[0] - p[0];
+                double y = (double)r[1] - p[1];
+                double angle = std::atan2(back_x * y - back_y * x, back_x * x + back_y * y);
+                if (result_left) angle = -angle; // clockwise
+                if (angle <= 0.0) angle += 2.0 * PI;
+                if (next < 0 || angle < best) {
+                    next = j;
+                    best = angle;
+                }
+            }
+            if (next < 0) break;
+            position = next;
+        }
+        if (same_point(contour.points.back(), contour.points.front())) {
+            contour.points.pop_back(); // back at the start
+        }
+        contours.push_back(contour);
+    }
+
+    std::vector<std::vector<Vector2>> rings;
+    for (Contour& contour : contours) {
+        if (contour.hole_of >= 0) continue;
+        if (signed_area(contour.points) < 0.0) std::reverse(contour.points.begin(), contour.points.end());
+        rings.push_back(contour.points);
+        for (int hole : contour.holes) {
+            std::vector<Vector2>& points = contours[hole].points;
+            if (signed_area(points) > 0.0) std::reverse(points.begin(), points.end());
+            rings.push_back(points);
+        }
+    }
+    return rings;
+}
+
+std::vector<std::vector<Vector2>> polygon_boolean(std::vector<std::vector<Vector2>> const& a, std::vector<std::vector<Vector2>> const& b, PolygonOperation operation) {
+    PolygonSweep sweep;
+    sweep.operation = operation;
+    sweep.add_edges(a, true);
+    sweep.add_edges(b, false);
+    
+    float right_bound = std::numeric_limits<float>::infinity();
+    if (operation != PolygonUnion) {
+        // nothing right of a is in a difference, right of either in an intersection
+        float a_right = -right_bound;
+        float b_right = -right_bound;
+        for (std::vector<Vector2> const& ring : a) {
+            for (Vector2 const& p : ring) a_right = std::max(a_right, p[0]);
+        }
+        for (std::vector<Vector2> const& ring : b) {
+            for (Vector2 const& p : ring) b_right = std::max(b_right, p[0]);
+        }
+        right_bound = operation == PolygonDifference ? a_right : std::min(a_right, b_right);
+    }
+    sweep.sweep(right_bound);
+    return sweep.connect_edges();
+}
@@ -0,0 +1,56 @@
+//
+//  Polygon.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __LD29__Polygon__
+#define __LD29__Polygon__
+
+#include <stdint.h>
+#include <vector>
+#include "Types.h"
+
+/*
+ * Triangulates a simple polygon by ear clipping on a linked list of its
+ * vertices. An ear is clipped where it is found and the search goes on from
+ * its neighbour over the convex vertices only, and only the reflex vertices
+ * in the ear's bounding box are tested against it, found through a z-order
+ * index once there are more than 80 vertices. Smooth outlines take close to
+ * O(n log n), about a second for 10^6 vertices, but the worst case, long
+ * slivers over many reflex vertices, is still quadratic.
+ *
+ * Weakly simple polygons work as well, like the ones cut() makes: a hole
+ * joined to the outline by a bridge, two coincident edges in opposite
+ * directions, with its end points twice in points. Repeated points and
+ * collinear vertices may be left out of the triangles, which still cover the
+ * polygon. Self intersecting input gets some triangulation, not a correct
+ * one.
+ *
+ * Returns three indices into points per triangle, counter clockwise, for
+ * points in either orientation.
+ */
+std::vector<uint32_t> triangulate_polygon(std::vector<Vector2> const& points);
+
+typedef enum {
+    PolygonDifference,
+    PolygonUnion,
+    PolygonIntersection
+} PolygonOperation;
+
+/*
+ * Boolean operations on polygons given as rings, each counter clockwise
+ * outline followed by its holes, by a sweep line over all edges: O((n + k)
+ * log n) for n edges crossing k times. An edge in the rings of a polygon
+ * twice cancels out, so the weakly simple polygons cut() returns can be fed
+ * back in.
+ *
+ * Returns the rings of the result, each outline counter clockwise and
+ * followed by its holes, clockwise.
+ */
+std::vector<std::vector<Vector2>> polygon_boolean(std::vector<std::vector<Vector2>> const& a, std::vector<std::vector<Vector2>> const& b, PolygonOperation operation);
+// one polygon per outline with its holes joined to it by bridges, for triangulate()
+std::vector<std::vector<Vector2>> join_holes(std::vector<std::vector<Vector2>> const& rings);
+
+#endif /* defined(__LD29__Polygon__) */
@@ -0,0 +1,205 @@
+//
+//  Predicates.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "Predicates.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// The error free transformations below break if a multiply-add gets fused.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+static const double epsilon = 1.0 / 9007199254740992.0; // 2^-53, half an ulp of 1
+static const double splitter = 134217729.0; // 2^27 + 1
+static const double orient_error_bound = (3.0 + 16.0 * epsilon) * epsilon;
+static const double incircle_error_bound = (10.0 + 96.0 * epsilon) * epsilon;
+
+// a + b = x + y exactly, x is the rounded sum
+static inline void two_sum(double a, double b, double& x, double& y) {
+    x = a + b;
+    double b_virtual = x - a;
+    double a_virtual = x - b_virtual;
+    y = (a - a_virtual) + (b - b_virtual);
+}
+
+// the same for |a| >= |b|
+static inline void fast_two_sum(double a, double b, double& x, double& y) {
+    x = a + b;
+    y = b - (x - a);
+}
+
+static inline void two_diff(double a, double b, double& x, double& y) {
+    x = a - b;
+    double b_virtual = a - x;
+    double a_virtual = x + b_virtual;
+    y = (a - a_virtual) + (b_virtual - b);
+}
+
+// a = hi + lo with at most 26 significant bits each
+static inline void split(double a, double& hi, double& lo) {
+    double c = splitter * a;
+    hi = c - (c - a);
+    lo = a - hi;
+}
+
+// a * b = x + y exactly
+static inline void two_product(double a, double b, double& x, double& y) {
+    x = a * b;
+    double a_hi, a_lo, b_hi, b_lo;
+    split(a, a_hi, a_lo);
+    split(b, b_hi, b_lo);
+    double error = x - a_hi * b_hi - a_lo * b_hi - a_hi * b_lo;
+    y = a_lo * b_lo - error;
+}
+
+/*
+ * An expansion is a sum of doubles that do not overlap, from the smallest to
+ * the largest magnitude, without zeros. The last component has the sign of
+ * the sum; the empty expansion is zero.
+ */
+typedef std::vector<double> Expansion;
+
+static Expansion difference(double a, double b) {
+    double x, y;
+    two_diff(a, b, x, y);
+    Expansion h;
+    if (y != 0.0) h.push_back(y);
+    if (x != 0.0) h.push_back(x);
+    return h;
+}
+
+// merges the components by magnitude and adds them up from the smallest one
+static Expansion sum(Expansion const& e, Expansion const& f) {
+    Expansion g(e.size() + f.size());
+    std::merge(e.begin(), e.end(), f.begin(), f.end(), g.begin(), [](double a, double b) {
+        return std::fabs(a) < std::fabs(b);
+    });
+    if (g.empty()) return g;
+    size_t count = 0;
+    double q = g[0];
+    for (size_t i = 1; i < g.size(); ++i) {
+        double q_new, h;
+        two_sum(q, g[i], q_new, h);
+        if (h != 0.0) g[count++] = h;
+        q = q_new;
+    }
+    if (q != 0.0) g[count++] = q;
+    g.resize(count);
+    return g;
+}
+
+static Expansion scale(Expansion const& e, double b) {
+    Expansion h;
+    if (e.empty() || b == 0.0) return h;
+    double q, error;
+    two_product(e[0], b, q, error);
+    if (error != 0.0) h.push_back(error);
+    for (size_t i = 1; i < e.size(); ++i) {
+        double product_hi, product_lo, s;
+        two_product(e[i], b, product_hi, product_lo);
+        two_sum(q, product_lo, s, error);
+        if (error != 0.0) h.push_back(error);
+        fast_two_sum(product_hi, s, q, error);
+        if (error != 0.0) h.push_back(error);
+    }
+    if (q != 0.0) h.push_back(q);
+    return h;
+}
+
+static Expansion product(Expansion const& e, Expansion const& f) {
+    Expansion h;
+    for (double b : f) {
+        h = sum(h, scale(e, b));
+    }
+    return h;
+}
+
+static Expansion negate(Expansion e) {
+    for (double& c : e) c = -c;
+    return e;
+}
+
+static double most_significant(Expansion const& e) {
+    return e.empty() ? 0.0 : e.back();
+}
+
+static double orient2d_exact(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2) {
+    Expansion left = product(difference(p0[0], p2[0]), difference(p1[1], p2[1]));
+    Expansion right = product(difference(p0[1], p2[1]), difference(p1[0], p2[0]));
+    return most_significant(sum(left, negate(right)));
+}
+
+double orient2d(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2) {
+    double left = ((double)p0[0] - p2[0]) * ((double)p1[1] - p2[1]);
+    double right = ((double)p0[1] - p2[1]) * ((double)p1[0] - p2[0]);
+    double det = left - right;
+    // with different signs there is no cancellation
+    double magnitude;
+    if (left > 0.0) {
+        if (right <= 0.0) return det;
+        magnitude = left + right;
+    } else if (left < 0.0) {
+        if (right >= 0.0) return det;
+        magnitude = -left - right;
+    } else {
+        return det;
+    }
+    double bound = orient_error_bound * magnitude;
+    if (det >= bound || -det >= bound) {
+        return det;
+    }
+    return orient2d_exact(p0, p1, p2);
+}
+
+static double incircle_exact(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2, Vector2 const& p3) {
+    Expansion ax = difference(p0[0], p3[0]);
+    Expansion ay = difference(p0[1], p3[1]);
+    Expansion bx = difference(p1[0], p3[0]);
+    Expansion by = difference(p1[1], p3[1]);
+    Expansion cx = difference(p2[0], p3[0]);
+    Expansion cy = difference(p2[1], p3[1]);
+    Expansion a_lift = sum(product(ax, ax), product(ay, ay));
+    Expansion b_lift = sum(product(bx, bx), product(by, by));
+    Expansion c_lift = sum(product(cx, cx), product(cy, cy));
+    Expansion bc = sum(product(bx, cy), negate(product(by, cx)));
+    Expansion ca = sum(product(cx, ay), negate(product(cy, ax)));
+    Expansion ab = sum(product(ax, by), negate(product(ay, bx)));
+    return most_significant(sum(sum(product(a_lift, bc), product(b_lift, ca)), product(c_lift, ab)));
+}
+
+double incircle(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2, Vector2 const& p3) {
+    double ax = (double)p0[0] - p3[0];
+    double ay = (double)p0[1] - p3[1];
+    double bx = (double)p1[0] - p3[0];
+    double by = (double)p1[1] - p3[1];
+    double cx = (double)p2[0] - p3[0];
+    double cy = (double)p2[1] - p3[1];
+
+    double bxcy = bx * cy;
+    double cxby = cx * by;
+    double a_lift = ax * ax + ay * ay;
+    double cxay = cx * ay;
+    double axcy = ax * cy;
+    double b_lift = bx * bx + by * by;
+    double axby = ax * by;
+    double bxay = bx * ay;
+    double c_lift = cx * cx + cy * cy;
+
+    double det = a_lift * (bxcy - cxby) + b_lift * (cxay - axcy) + c_lift * (axby - bxay);
+    double permanent = (std::fabs(bxcy) + std::fabs(cxby)) * a_lift
+                     + (std::fabs(cxay) + std::fabs(axcy)) * b_lift
+                     + (std::fabs(axby) + std::fabs(bxay)) * c_lift;
+    double bound = incircle_error_bound * permanent;
+    if (det > bound || -det > bound) {
+        return det;
+    }
+    return incircle_exact(p0, p1, p2, p3);
+}
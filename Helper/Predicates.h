@@ -0,0 +1,27 @@
+//
+//  Predicates.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __LD29__Predicates__
+#define __LD29__Predicates__
+
+#include "Types.h"
+
+/*
+ * Geometric predicates with exactly the right sign. The determinant is
+ * evaluated in double first; only if its error bound does not rule out the
+ * other sign, it is evaluated again in exact expansion arithmetic (Shewchuk,
+ * "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric
+ * Predicates"). Only the sign of the result is exact.
+ */
+
+// > 0 if p0, p1, p2 are counter clockwise, < 0 if clockwise, 0 if collinear
+double orient2d(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2);
+// > 0 if p3 is inside the circle through the counter clockwise p0, p1, p2,
+// < 0 if outside and 0 if on it; the sign flips for clockwise p0, p1, p2
+double incircle(Vector2 const& p0, Vector2 const& p1, Vector2 const& p2, Vector2 const& p3);
+
+#endif /* defined(__LD29__Predicates__) */
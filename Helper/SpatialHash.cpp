@@ -0,0 +1,84 @@
+//
+//  SpatialHash.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "SpatialHash.h"
+#include <cmath>
+
+SpatialHash::Cell SpatialHash::cell(Vector2 const& p) const {
+    return Cell{(int32_t)std::floor(p[0] / _cell_size), (int32_t)std::floor(p[1] / _cell_size)};
+}
+
+uint32_t SpatialHash::bucket(Cell const& c) const {
+    // _head.size() is a power of two
+    return ((uint32_t)c.x * 73856093u ^ (uint32_t)c.y * 19349663u) & (uint32_t)(_head.size() - 1);
+}
+
+void SpatialHash::link(uint32_t i) {
+    uint32_t b = bucket(_cells[i]);
+    _next[i] = _head[b];
+    _head[b] = i;
+}
+
+void SpatialHash::unlink(uint32_t i) {
+    int32_t* link = &_head[bucket(_cells[i])];
+    while (*link != (int32_t)i) {
+        link = &_next[*link];
+    }
+    *link = _next[i];
+}
+
+void SpatialHash::build(std::vector<Vector2> const& points) {
+    size_t buckets = 16;
+    while (buckets < 2 * points.size()) {
+        buckets *= 2;
+    }
+    _points = points;
+    _cells.resize(points.size());
+    _head.assign(buckets, -1);
+    _next.resize(points.size());
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        _cells[i] = cell(points[i]);
+        link(i);
+    }
+}
+
+void SpatialHash::update(std::vector<Vector2> const& points) {
+    if (points.size() != _points.size()) {
+        build(points);
+        return;
+    }
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        _points[i] = points[i];
+        Cell c = cell(points[i]);
+        if (!(c == _cells[i])) {
+            unlink(i);
+            _cells[i] = c;
+            link(i);
+        }
+    }
+}
+
+void SpatialHash::query(Vector2 const& center, float radius, std::vector<uint32_t>& found) const {
+    if (_points.empty()) return;
+    Cell lower = cell(Vector2(center[0] - radius, center[1] - radius));
+    Cell upper = cell(Vector2(center[0] + radius, center[1] + radius));
+    float r2 = radius * radius;
+    for (int32_t y = lower.y; y <= upper.y; ++y) {
+        for (int32_t x = lower.x; x <= upper.x; ++x) {
+            Cell c = {x, y};
+            // other cells hashed to the same bucket are skipped by their cell
+            for (int32_t i = _head[bucket(c)]; i != -1; i = _next[i]) {
+                if (!(_cells[i] == c)) continue;
+                float dx = _points[i][0] - center[0];
+                float dy = _points[i][1] - center[1];
+                if (dx * dx + dy * dy <= r2) {
+                    found.push_back(i);
+                }
+            }
+        }
+    }
+}
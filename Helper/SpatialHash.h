@@ -0,0 +1,62 @@
+//
+//  SpatialHash.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __LD29__SpatialHash__
+#define __LD29__SpatialHash__
+
+#include <stdint.h>
+#include <vector>
+#include "Types.h"
+
+/*
+ * Uniform grid over points in the plane, for finding the points near a
+ * position without testing all of them. The grid is unbounded: cells are
+ * hashed into a table of about twice as many buckets as there are points, and
+ * the points of a bucket are linked through their indices. A query looks at
+ * the cells its circle overlaps, so with cells about as large as the query
+ * radius it visits the points of nine cells.
+ *
+ * update() keeps the table when the number of points stays the same and only
+ * relinks the points that moved into another cell, which is the common case
+ * when points are moved a little at a time.
+ */
+class SpatialHash {
+    struct Cell {
+        int32_t x, y;
+
+        bool operator == (Cell const& other) const {
+            return x == other.x && y == other.y;
+        }
+    };
+
+    float _cell_size;
+    std::vector<Vector2> _points;
+    std::vector<Cell> _cells;   // cell of every point
+    std::vector<int32_t> _head; // first point in every bucket, -1 if empty
+    std::vector<int32_t> _next; // next point in the same bucket, -1 at the end
+
+    Cell cell(Vector2 const& p) const;
+    uint32_t bucket(Cell const& c) const;
+    void link(uint32_t i);
+    void unlink(uint32_t i);
+
+public:
+    SpatialHash(float cell_size) : _cell_size(cell_size) {}
+
+    void build(std::vector<Vector2> const& points);
+    // same as build(points), but for as many points as before only those that
+    // changed their cell are moved to another bucket
+    void update(std::vector<Vector2> const& points);
+
+    // appends the indices of the points with a distance of at most radius to
+    // center, in no particular order
+    void query(Vector2 const& center, float radius, std::vector<uint32_t>& found) const;
+
+    size_t size() const { return _points.size(); }
+};
+
+#endif /* defined(__LD29__SpatialHash__) */
@@ -13,7 +13,7 @@
 
 GameCore::GameCore(int view_width, int view_height)
 : _view_width(view_width), _view_height(view_height),
-_camera_zoom(0.0f), _second_timer(0.0f), _rand_engine((unsigned int)time(0)),
+_camera_zoom(0.0f), _second_timer(0.0f), _rand_engine((uint64_t)time(0)),
 _game_over(false) {
     _kingdom_colors[0] = Color4(100, 30, 30, 255);
     _kingdom_colors[1] = Color4(30, 100, 100, 255);
@@ -87,6 +87,8 @@ _game_over(false) {
     init_decal_mesh(_decal_mesh);
     init_star_mesh(_star_mesh);
     
+    init_tile_bounds();
+    
     gl_init(_camera, _background_color);
     
     _projection = _camera.projection();
@@ -116,6 +118,31 @@ void GameCore::mouse_wheel(float w) {
     _camera_zoom += 0.5f * w;
 }
 
+// how far mines and coins reach above and beside a tile
+static const float tile_decoration_height = 0.4f;
+static const float tile_decoration_margin = 0.3f;
+
+void GameCore::init_tile_bounds() {
+    std::vector<Tile*> const& tiles = _map.tiles();
+    _tile_bound_x.resize(tiles.size());
+    _tile_bound_y.resize(tiles.size());
+    _tile_bound_z.resize(tiles.size());
+    _tile_bound_radius.resize(tiles.size());
+    _tile_visible.resize(tiles.size());
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        Tile* tile = tiles[i];
+        float r2 = 0.0f;
+        for (Vector3 const& v : tile->shape) {
+            r2 = std::max(r2, squared_length(v - tile->center));
+        }
+        float half_height = 0.5f * tile_decoration_height;
+        _tile_bound_x[i] = tile->center[0];
+        _tile_bound_y[i] = tile->center[1] + half_height;
+        _tile_bound_z[i] = tile->center[2];
+        _tile_bound_radius[i] = sqrtf(r2 + half_height * half_height) + tile_decoration_margin;
+    }
+}
+
 void GameCore::update_camera(float dt) {
     if (_camera_rotation[0] > -PI * 0.1f) {
         _camera_rotation[0] = -PI * 0.1f;
@@ -146,11 +173,12 @@ void GameCore::update_camera(float dt) {
     _camera.set_zoom(_camera_zoom);
     Vector3 camera_position = _camera.position();
     Vector3 camera_target_delta = _target_camera_position - camera_position;
-    _camera.set_position(camera_position + camera_target_delta * dt * 5.0f);
+    _camera.set_position(lazy(camera_position) + lazy(camera_target_delta) * dt * 5.0f);
     _view = _camera.transformation().world_to_local();
     _camera_model = _camera.transformation().local_to_world();
     
     _view_projection = _projection * _view;
+    _frustum = Frustum(_view_projection);
     Vector3 camera_normal = transformed_vector(_camera_model, Vector3(0.0f, 0.0f, 1.0f));
     Vector3 xz = vector_normal(camera_normal - Vector3(0.0f, 1.0f, 0.0f) * dot(Vector3(0.0f, 1.0f, 0.0f), camera_normal));
     float angle = atan2f(xz[0], xz[2]);
@@ -279,48 +307,48 @@ void GameCore::perform_move(Tile* destination) {
     next_turn_state();
 }
 
+// offsets of the unit decorations relative to the bobbing sprite
+static constexpr Matrix4 crown_offset = homogeneous_translation(Vector3(0.0f, 0.31f, 0.0f));
+static constexpr Matrix4 coin_offsets[] = {
+    homogeneous_translation(Vector3(-0.05f, 0.25f, 0.0f)),
+    homogeneous_translation(Vector3(0.05f, 0.25f, 0.0f)),
+    homogeneous_translation(Vector3(-0.05f, 0.15f, 0.0f)),
+    homogeneous_translation(Vector3(0.05f, 0.15f, 0.0f))
+};
+static constexpr Matrix4 decal_offset = homogeneous_translation(Vector3(0.0f, 0.16f, 0.0f));
+
+// a sphere around the flag and everything drawn on it, including the star
+static constexpr Vector3 unit_bound_offset = Vector3(0.0f, 0.35f, 0.0f);
+static const float unit_bound_radius = 0.5f;
+
 void GameCore::draw_unit(Unit const& unit) {
     Vector3 position = linear_interpolation(unit.location->center,
                                             unit.destination->center,
                                             _turn_timer);
+    if (!_frustum.sphere_visible(position + unit_bound_offset, unit_bound_radius)) {
+        return;
+    }
     
     Matrix4 model = homogeneous_translation(position);
     
     float t = 0.0f;
     if (current_unit().location == unit.location || _game_over) {
-        t = 0.01f * (1.0f + cosf(4.0f * PI * _second_timer));
+        t = 0.01f * (1.0f + _pulse_cos);
     }
+    Matrix4 sprite = _view * model * _sprite_rotation * homogeneous_translation(Vector3(0.0f, t, 0.0f));
     if (unit.type == 0) {
-        Matrix4 offset = homogeneous_translation(Vector3(0.0f, t, 0.0f));
-        gl_draw(_view * model * _sprite_rotation * offset, _flag_mesh, _kingdom_colors[unit.kingdom]);
-        offset = homogeneous_translation(Vector3(0.0f, t + 0.31f, 0.0f));
-        gl_draw(_view * model * _sprite_rotation * offset, _crown_mesh, _gold_color);
-        if (unit.coins > 0) {
-            offset = homogeneous_translation(Vector3(-0.05f, t + 0.25f, 0.0f));
-            gl_draw(_view * model * _sprite_rotation * offset, _coin_mesh, _gold_color);
-        }
-        if (unit.coins > 1) {
-            offset = homogeneous_translation(Vector3(0.05f, t + 0.25f, 0.0f));
-            gl_draw(_view * model * _sprite_rotation * offset, _coin_mesh, _gold_color);
-        }
-        if (unit.coins > 2) {
-            offset = homogeneous_translation(Vector3(-0.05f, t + 0.15f, 0.0f));
-            gl_draw(_view * model * _sprite_rotation * offset, _coin_mesh, _gold_color);
-        }
-        if (unit.coins > 3) {
-            offset = homogeneous_translation(Vector3(0.05f, t + 0.15f, 0.0f));
-            gl_draw(_view * model * _sprite_rotation * offset, _coin_mesh, _gold_color);
+        gl_draw(sprite, _flag_mesh, _kingdom_colors[unit.kingdom]);
+        gl_draw(sprite * crown_offset, _crown_mesh, _gold_color);
+        for (int i = 0; i < std::min(unit.coins, 4); ++i) {
+            gl_draw(sprite * coin_offsets[i], _coin_mesh, _gold_color);
         }
         
         if (_game_over) {
-            offset = homogeneous_translation(Vector3(0.0f, 4.0f * t + 0.45f, 0.0f));
-            gl_draw(_view * model * _sprite_rotation * offset, _star_mesh, _gold_color);
+            gl_draw(sprite * homogeneous_translation(Vector3(0.0f, 3.0f * t + 0.45f, 0.0f)), _star_mesh, _gold_color);
         }
     } else {
-        Matrix4 offset = homogeneous_translation(Vector3(0.0f, t, 0.0f));
-        gl_draw(_view * model * _sprite_rotation * offset, _small_flag_mesh, _kingdom_colors[unit.kingdom]);
-        offset = homogeneous_translation(Vector3(0.0f, t + 0.16f, 0.0f));
-        gl_draw(_view * model * _sprite_rotation * offset, _decal_mesh, _gold_color);
+        gl_draw(sprite, _small_flag_mesh, _kingdom_colors[unit.kingdom]);
+        gl_draw(sprite * decal_offset, _decal_mesh, _gold_color);
     }
 }
 
@@ -452,6 +480,23 @@ void GameCore::remove_kingdom(int kingdom) {
     }
 }
 
+// All animations only depend on the second timer, so their sines and cosines
+// are evaluated once per frame, in one batch, instead of per tile and unit.
+void GameCore::update_animation() {
+    float phases[] = {
+        (float)(4.0f * PI * _second_timer),  // highlight pulse
+        (float)(2.0f * PI * _second_timer),  // coin and indicator bobbing
+        (float)(PI * _second_timer)          // half the mine wheel angle
+    };
+    float sines[3];
+    float cosines[3];
+    batch_sincos(phases, sines, cosines, 3);
+    _pulse_sin = sines[0];
+    _pulse_cos = cosines[0];
+    _bob_sin = sines[1];
+    _wheel_rotation = homogeneous_rotation(Quaternion<float>(cosines[2], 0.0f, 0.0f, sines[2]));
+}
+
 void GameCore::update(float dt) {
     _second_timer += dt;
     if (_second_timer > 1.0f) {
@@ -461,6 +506,7 @@ void GameCore::update(float dt) {
     gl_clear();
     
     update_camera(dt);
+    update_animation();
     
     std::vector<Tile*> valid;
     if (current_unit().coins >= 4) {
@@ -479,14 +525,24 @@ void GameCore::update(float dt) {
         }
     }
     
-    for (Tile* c : _map.tiles()) {
+    std::vector<Tile*> const& tiles = _map.tiles();
+    if (!tiles.empty()) {
+        _frustum.batch_spheres_visible(&_tile_bound_x[0], &_tile_bound_y[0], &_tile_bound_z[0],
+                                       &_tile_bound_radius[0], &_tile_visible[0], (int)tiles.size());
+    }
+    
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (!_tile_visible[i]) {
+            continue;
+        }
+        Tile* c = tiles[i];
         Color4 color(_cell_color);
         if (c->kingdom >= 0) {
             color = _kingdom_map_colors[c->kingdom];
         }
         
         if (!_game_over && std::find(valid.begin(), valid.end(), c) != valid.end()) {
-            float t = 0.5f * (1.0f + sinf(4.0f * PI * _second_timer));
+            float t = 0.5f * (1.0f + _pulse_sin);
             Color4 fade_color = _kingdom_map_highlight_colors[current_unit().kingdom];
             if (c == _selected_cell) {
                 fade_color = _select_color;
@@ -497,19 +553,22 @@ void GameCore::update(float dt) {
         gl_draw(_view, c->shape, color);
     }
     
-    for (Tile* c : _map.tiles()) {
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (!_tile_visible[i]) {
+            continue;
+        }
+        Tile* c = tiles[i];
         if (c->building == 1) {
             Matrix4 model = homogeneous_translation(c->center);
             Matrix4 offset = homogeneous_translation(Vector3(0.1f, 0.0f, 0.1f));
             gl_draw(_view * model * _sprite_rotation * offset, _mine_base_mesh, Color4(40, 40, 40, 255));
             offset = homogeneous_translation(Vector3(0.1f, 0.1f, 0.1f));
-            Matrix4 rot = homogeneous_rotation(Quaternion<float>(Vector3(0.0f, 0.0f, 1.0f), _second_timer * 2.0f * PI));
-            gl_draw(_view * model * _sprite_rotation * offset * rot, _mine_wheel_mesh, Color4(40, 40, 40, 255));
+            gl_draw(_view * model * _sprite_rotation * offset * _wheel_rotation, _mine_wheel_mesh, Color4(40, 40, 40, 255));
         }
         
         if (c->coins > 0) {
             Matrix4 model = homogeneous_translation(c->center);
-            Matrix4 offset = homogeneous_translation(Vector3(0.1f, 0.25f + 0.025f * sinf(_second_timer * 2.0f * PI), 0.1f));
+            Matrix4 offset = homogeneous_translation(Vector3(0.1f, 0.25f + 0.025f * _bob_sin, 0.1f));
             gl_draw(_view * model * _sprite_rotation * offset, _coin_mesh, _gold_color);
         }
     }
@@ -551,7 +610,7 @@ void GameCore::update(float dt) {
     // draw indicator
     gl_disable_depth();
     if (current_unit().kingdom == 0 && _turn_state == 1 && _selected_cell && !_game_over) {
-        float t = 0.05f + 0.05f * sinf(_second_timer * 2.0f * PI);
+        float t = 0.05f + 0.05f * _bob_sin;
         Matrix4 model = homogeneous_translation(_selected_cell->center);
         if (current_unit().coins >= 4) {
             gl_draw(_view * model * _sprite_rotation * homogeneous_translation(Vector3(0.0f, t, 0.0f)), _small_flag_mesh, _kingdom_colors[current_unit().kingdom]);
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <random>
 #include "Camera.h"
+#include "Frustum.h"
 #include "Types.h"
 #include "GameShapes.h"
 #include "GameMap.h"
@@ -39,7 +40,7 @@ class GameCore {
     float _camera_zoom;
     Vector3 _target_camera_position;
     
-    std::mt19937 _rand_engine;
+    RandomStream _rand_engine;
     
     GameMap _map;
     
@@ -69,6 +70,16 @@ class GameCore {
     Matrix4 _view_projection;
     Matrix4 _sprite_rotation;
     Matrix4 _camera_model;
+    Frustum _frustum;
+    
+    // bounding spheres of the tiles and their decorations, in the order of
+    // _map.tiles(), and which of them are in view this frame
+    std::vector<float> _tile_bound_x;
+    std::vector<float> _tile_bound_y;
+    std::vector<float> _tile_bound_z;
+    std::vector<float> _tile_bound_radius;
+    std::vector<unsigned char> _tile_visible;
+    void init_tile_bounds();
     
     void update_camera(float dt);
     
@@ -96,6 +107,13 @@ class GameCore {
     
     float _second_timer;
     
+    // animation values of the current frame, see update_animation
+    float _pulse_sin;
+    float _pulse_cos;
+    float _bob_sin;
+    Matrix4 _wheel_rotation;
+    void update_animation();
+    
     bool _game_over;
     Tile* _winner_location;
     
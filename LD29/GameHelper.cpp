@@ -7,6 +7,7 @@
 //
 
 #include "GameHelper.h"
+#include "Kernels.h"
 
 Color4 color_interpolation(Color4 const& color0, Color4 const& color1, float t) {
     Vector3 v0(color0[0]/255.0f, color0[1]/255.0f, color0[2]/255.0f);
@@ -20,14 +21,42 @@ Vector2 point_on_screen(Matrix4 const& view_projection, Vector3 const& p) {
     return Vector2(proj[0]/fabs(proj[3]), proj[1]/fabs(proj[3]));
 }
 
+// vertices are projected in chunks of this size, a multiple of 3 for triangles
+static const int screen_chunk = 255;
+
+// Projects count <= screen_chunk vertices like point_on_screen does. The
+// scalar kernels gain nothing over point_on_screen and would only add the copy
+// into separate arrays, so without SIMD kernels the vertices go one by one.
+static void points_on_screen(Matrix4 const& view_projection, Vector3 const* vertices, int count, float* x, float* y) {
+    if (active_kernel_set() == KernelScalar) {
+        for (int i = 0; i < count; ++i) {
+            Vector2 p = point_on_screen(view_projection, vertices[i]);
+            x[i] = p[0];
+            y[i] = p[1];
+        }
+        return;
+    }
+    float vx[screen_chunk], vy[screen_chunk], vz[screen_chunk];
+    for (int i = 0; i < count; ++i) {
+        vx[i] = vertices[i][0];
+        vy[i] = vertices[i][1];
+        vz[i] = vertices[i][2];
+    }
+    batch_transform_points(view_projection, vx, vy, vz, x, y, 0, 0, count, PerspectiveDivideAbsolute);
+}
+
 Rect2 rect_on_screen(Matrix4 const& view_projection, std::vector<Vector3> const& vertices) {
-    Vector2 p = point_on_screen(view_projection, vertices[0]);
-    Vector2 min = p;
-    Vector2 max = p;
-    for (Vector3 const& v : vertices) {
-        p = point_on_screen(view_projection, v);
-        min = minimum(min, p);
-        max = maximum(max, p);
+    Vector2 min = point_on_screen(view_projection, vertices[0]);
+    Vector2 max = min;
+    float x[screen_chunk], y[screen_chunk];
+    for (int begin = 0; begin < (int)vertices.size(); begin += screen_chunk) {
+        int count = std::min(screen_chunk, (int)vertices.size() - begin);
+        points_on_screen(view_projection, &vertices[begin], count, x, y);
+        for (int i = 0; i < count; ++i) {
+            Vector2 p(x[i], y[i]);
+            min = minimum(min, p);
+            max = maximum(max, p);
+        }
     }
     return Rect2{min, max - min};
 }
@@ -37,13 +66,18 @@ bool point_in_rect(Rect2 const& r, Vector2 const& p) {
 }
 
 bool cursor_on_shape(Matrix4 const& model_view_projection, std::vector<Vector3> const& vertices, Vector2 const& cursor) {
-    for (int i = 0; i < vertices.size(); i+=3) {
-        Vector2 p0 = point_on_screen(model_view_projection, vertices[i+0]);
-        Vector2 p1 = point_on_screen(model_view_projection, vertices[i+1]);
-        Vector2 p2 = point_on_screen(model_view_projection, vertices[i+2]);
-        if (area(p0, p1, cursor) <= 0.0f && area(p1, p2, cursor) <= 0.0f && area(p2, p0, cursor) <= 0.0f) {
-            return true;
+    float x[screen_chunk], y[screen_chunk];
+    for (int begin = 0; begin + 2 < (int)vertices.size(); begin += screen_chunk) {
+        int count = std::min(screen_chunk, (int)vertices.size() - begin);
+        points_on_screen(model_view_projection, &vertices[begin], count, x, y);
+        for (int i = 0; i + 2 < count; i += 3) {
+            Vector2 p0(x[i+0], y[i+0]);
+            Vector2 p1(x[i+1], y[i+1]);
+            Vector2 p2(x[i+2], y[i+2]);
+            if (area(p0, p1, cursor) <= 0.0f && area(p1, p2, cursor) <= 0.0f && area(p2, p0, cursor) <= 0.0f) {
+                return true;
+            }
         }
     }
     return false;
-}
\ No newline at end of file
+}
@@ -8,6 +8,8 @@
 
 #include "GameMap.h"
 #include "DelaunayTriangulation.h"
+#include "SpatialHash.h"
+#include <algorithm>
 #include <map>
 #include <random>
 
@@ -15,18 +17,27 @@ bool neighbours(Tile* t0, Tile* t1) {
     return std::find(t0->neighbours.begin(), t0->neighbours.end(), t1) != t0->neighbours.end();
 }
 
-std::vector<Vector2> smooth(float width, float height, std::vector<Vector2> const& points) {
+// pushes apart points closer than 1.0; grid is kept between passes, so only
+// the points that moved into another cell are relinked
+std::vector<Vector2> smooth(float width, float height, std::vector<Vector2> const& points, SpatialHash& grid) {
     float const k = 0.01f;
+    grid.update(points);
     std::vector<Vector2> result(points.size());
+    std::vector<uint32_t> near;
     for (int i = 0; i < result.size(); ++i) {
         Vector2 old = points[i];
         result[i] = old;
-        for (int j = 0; j < points.size(); ++j) {
-            if (i == j) continue;
+        near.clear();
+        grid.query(old, 1.0f, near);
+        // in index order, so the sum is the same as over all points
+        std::sort(near.begin(), near.end());
+        for (uint32_t j : near) {
+            if (j == (uint32_t)i) continue;
             Vector2 diff = points[j] - old;
             float len = length(diff);
             if (len < 1.0f) {
-                result[i] -= k * 1.0f/len * vector_normal(diff);
+                // k / len * vector_normal(diff), without the temporaries
+                result[i] -= k * 1.0f/len * (lazy(diff) / (len + 0.000000000001f));
             }
         }
     }
@@ -51,12 +62,14 @@ GameMap::GameMap() {
     for (int i = 0; i < 200; ++i) {
         points.push_back(Vector2(dist(rand_engine), dist(rand_engine)));
     }
+    SpatialHash grid(1.0f);
     for (int i = 0; i < 10; ++i) {
-        points = smooth(size, size, points);
+        points = smooth(size, size, points, grid);
     }
+    Arena<Point2> point_arena;
     std::vector<Point2*> ppoints;
     for (Vector2 const& p : points) {
-        ppoints.push_back(new Point2{p});
+        ppoints.push_back(point_arena.create(p));
     }
     
     {
@@ -103,7 +116,8 @@ GameMap::GameMap() {
             _tiles.push_back(new Tile());
             cell_tiles.insert(std::make_pair(cell, _tiles.back()));
             _tiles.back()->center = Vector3(cell->p->l[0], 0.0f, cell->p->l[1]);
-            _tiles.back()->shape = voronoi_cell_mesh(size, size, cell);
+            uint32_t site = vd.site(cell);
+            _tiles.back()->shape = convex_polygon_mesh(vd.polygons().begin(site), vd.polygons().end(site), 0.01f);
         }
         
         // 4.) Connect tiles
@@ -117,11 +131,6 @@ GameMap::GameMap() {
             }
         }
     }
-    
-    // free the points
-    for (Point2* p : ppoints) {
-        delete p;
-    }
 }
 
 GameMap::~GameMap() {
@@ -0,0 +1,109 @@
+//
+//  FastTrigonometry.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "FastTrigonometry.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FAST_TRIGONOMETRY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// The vector path only matches the scalar one if no multiply-add gets fused.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+// x - quadrant * PI/2, with PI/2 split into parts whose products with the
+// quadrant are exact
+static inline float fast_trig_reduce(float x, float quadrant) {
+    return ((x - quadrant * 1.5703125f) - quadrant * 4.837512969970703125e-4f) - quadrant * 7.549789954891882e-8f;
+}
+
+// nearest multiple of PI/2, ties away from zero
+static inline int fast_trig_quadrant(float x) {
+    float t = x * 0.636619772367581343f;
+    return (int)(t + (t < 0.0f ? -0.5f : 0.5f));
+}
+
+// sin(r) and cos(r) for r in [-PI/4, PI/4], r2 = r * r
+static inline float fast_trig_sin(float r, float r2) {
+    return r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+}
+
+static inline float fast_trig_cos(float r2) {
+    return (1.0f - 0.5f * r2) + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+}
+
+void fast_sincos(float x, float& s, float& c) {
+    int q = fast_trig_quadrant(x);
+    float r = fast_trig_reduce(x, (float)q);
+    float r2 = r * r;
+    float ps = fast_trig_sin(r, r2);
+    float pc = fast_trig_cos(r2);
+    // rotate by the quadrant
+    float qs = (q & 1) ? pc : ps;
+    float qc = (q & 1) ? ps : pc;
+    s = (q & 2) ? -qs : qs;
+    c = ((q + 1) & 2) ? -qc : qc;
+}
+
+#ifdef FAST_TRIGONOMETRY_SSE2
+
+// The scalar steps of fast_sincos on four phases at once.
+static inline void sincos_sse2(__m128 x, __m128& s, __m128& c) {
+    __m128 sign_mask = _mm_set1_ps(-0.0f);
+    __m128 t = _mm_mul_ps(x, _mm_set1_ps(0.636619772367581343f));
+    __m128 half = _mm_or_ps(_mm_and_ps(t, sign_mask), _mm_set1_ps(0.5f));
+    __m128i q = _mm_cvttps_epi32(_mm_add_ps(t, half));
+    __m128 qf = _mm_cvtepi32_ps(q);
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(7.549789954891882e-8f)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_set1_ps(8.3321608736e-3f), _mm_mul_ps(r2, _mm_set1_ps(-1.9515295891e-4f)));
+    ps = _mm_add_ps(_mm_set1_ps(-1.6666654611e-1f), _mm_mul_ps(r2, ps));
+    ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), ps));
+
+    __m128 pc = _mm_add_ps(_mm_set1_ps(-1.388731625493765e-3f), _mm_mul_ps(r2, _mm_set1_ps(2.443315711809948e-5f)));
+    pc = _mm_add_ps(_mm_set1_ps(4.166664568298827e-2f), _mm_mul_ps(r2, pc));
+    pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), pc));
+
+    // rotate by the quadrant
+    __m128i one = _mm_set1_epi32(1);
+    __m128i two = _mm_set1_epi32(2);
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 qs = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+    __m128 qc = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+    __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+    s = _mm_xor_ps(qs, sin_sign);
+    c = _mm_xor_ps(qc, cos_sign);
+}
+
+#endif
+
+void batch_sincos(const float* x, float* s, float* c, int count) {
+    int i = 0;
+#ifdef FAST_TRIGONOMETRY_SSE2
+    for (; i + 4 <= count; i += 4) {
+        __m128 vs, vc;
+        sincos_sse2(_mm_loadu_ps(x + i), vs, vc);
+        if (s) _mm_storeu_ps(s + i, vs);
+        if (c) _mm_storeu_ps(c + i, vc);
+    }
+#endif
+    for (; i < count; ++i) {
+        float vs, vc;
+        fast_sincos(x[i], vs, vc);
+        if (s) s[i] = vs;
+        if (c) c[i] = vc;
+    }
+}
@@ -0,0 +1,44 @@
+//
+//  FastTrigonometry.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __game__FastTrigonometry__
+#define __game__FastTrigonometry__
+
+/*
+ * Polynomial sin and cos approximations for animation and other per frame
+ * values. The argument is reduced to [-PI/4, PI/4] in three steps, followed
+ * by a degree 7 (sin) or degree 8 (cos) polynomial, without branches or table
+ * lookups.
+ *
+ * For |x| <= 8192 the absolute error is below 1e-7 (9.3e-8 measured), about
+ * one float ulp at 1. Outside that range the reduction loses precision; use
+ * sinf/cosf there.
+ */
+
+// fast_sincos is compiled in FastTrigonometry.cpp, where no multiply-add gets
+// fused, so it gives the same bits as batch_sincos whatever the caller's flags
+void fast_sincos(float x, float& s, float& c);
+
+inline float fast_sin(float x) {
+    float s, c;
+    fast_sincos(x, s, c);
+    return s;
+}
+
+inline float fast_cos(float x) {
+    float s, c;
+    fast_sincos(x, s, c);
+    return c;
+}
+
+/*
+ * s[i] = fast_sin(x[i]), c[i] = fast_cos(x[i]), several phases per
+ * instruction. s or c may be null. Bit identical to the scalar functions.
+ */
+void batch_sincos(const float* x, float* s, float* c, int count);
+
+#endif /* defined(__game__FastTrigonometry__) */
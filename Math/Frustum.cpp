@@ -0,0 +1,122 @@
+//
+//  Frustum.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "Frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FRUSTUM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// The vector path only matches the scalar one if no multiply-add gets fused.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+Frustum::Frustum() {
+
+}
+
+// Gribb and Hartmann: a point is inside if -w <= x, y, z <= w in clip space,
+// so every plane is the fourth row of the matrix plus or minus another row.
+Frustum::Frustum(const Matrix<float, 4, 4>& m) {
+    for (int row = 0; row < 3; ++row) {
+        _planes[2 * row] = Plane3(m(3, 0) + m(row, 0), m(3, 1) + m(row, 1),
+                                  m(3, 2) + m(row, 2), m(3, 3) + m(row, 3));
+        _planes[2 * row + 1] = Plane3(m(3, 0) - m(row, 0), m(3, 1) - m(row, 1),
+                                      m(3, 2) - m(row, 2), m(3, 3) - m(row, 3));
+    }
+}
+
+bool Frustum::sphere_visible(const Vector<float, 3>& center, float radius) const {
+    for (int i = 0; i < 6; ++i) {
+        if (_planes[i].distance(center) < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::aabb_visible(const Vector<float, 3>& min, const Vector<float, 3>& max) const {
+    for (int i = 0; i < 6; ++i) {
+        // the corner furthest along the normal
+        const Plane3& p = _planes[i];
+        Vector<float, 3> corner(p.a() >= 0.0f ? max[0] : min[0],
+                                p.b() >= 0.0f ? max[1] : min[1],
+                                p.c() >= 0.0f ? max[2] : min[2]);
+        if (p.distance(corner) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef FRUSTUM_SSE2
+
+// Plane3::distance on four points
+static inline __m128 plane_distance_sse2(const Plane3& p, __m128 x, __m128 y, __m128 z) {
+    __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.a()), x), _mm_mul_ps(_mm_set1_ps(p.b()), y));
+    d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(p.c()), z));
+    return _mm_add_ps(d, _mm_set1_ps(p.d()));
+}
+
+static inline void store_mask(int mask, unsigned char* visible) {
+    visible[0] = (unsigned char)(mask & 1);
+    visible[1] = (unsigned char)((mask >> 1) & 1);
+    visible[2] = (unsigned char)((mask >> 2) & 1);
+    visible[3] = (unsigned char)((mask >> 3) & 1);
+}
+
+#endif
+
+void Frustum::batch_spheres_visible(const float* x, const float* y, const float* z, const float* radius,
+                                    unsigned char* visible, int count) const {
+    int i = 0;
+#ifdef FRUSTUM_SSE2
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 vz = _mm_loadu_ps(z + i);
+        __m128 negative_radius = _mm_xor_ps(_mm_loadu_ps(radius + i), _mm_set1_ps(-0.0f));
+        __m128 outside = _mm_setzero_ps();
+        for (int k = 0; k < 6; ++k) {
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(plane_distance_sse2(_planes[k], vx, vy, vz), negative_radius));
+        }
+        store_mask(~_mm_movemask_ps(outside), visible + i);
+    }
+#endif
+    for (; i < count; ++i) {
+        visible[i] = sphere_visible(Vector<float, 3>(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+    }
+}
+
+void Frustum::batch_aabbs_visible(const float* min_x, const float* min_y, const float* min_z,
+                                  const float* max_x, const float* max_y, const float* max_z,
+                                  unsigned char* visible, int count) const {
+    int i = 0;
+#ifdef FRUSTUM_SSE2
+    for (; i + 4 <= count; i += 4) {
+        __m128 lo[3] = {_mm_loadu_ps(min_x + i), _mm_loadu_ps(min_y + i), _mm_loadu_ps(min_z + i)};
+        __m128 hi[3] = {_mm_loadu_ps(max_x + i), _mm_loadu_ps(max_y + i), _mm_loadu_ps(max_z + i)};
+        __m128 outside = _mm_setzero_ps();
+        for (int k = 0; k < 6; ++k) {
+            const Plane3& p = _planes[k];
+            __m128 vx = p.a() >= 0.0f ? hi[0] : lo[0];
+            __m128 vy = p.b() >= 0.0f ? hi[1] : lo[1];
+            __m128 vz = p.c() >= 0.0f ? hi[2] : lo[2];
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(plane_distance_sse2(p, vx, vy, vz), _mm_setzero_ps()));
+        }
+        store_mask(~_mm_movemask_ps(outside), visible + i);
+    }
+#endif
+    for (; i < count; ++i) {
+        visible[i] = aabb_visible(Vector<float, 3>(min_x[i], min_y[i], min_z[i]),
+                                  Vector<float, 3>(max_x[i], max_y[i], max_z[i])) ? 1 : 0;
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  Frustum.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __game__Frustum__
+#define __game__Frustum__
+
+#include "Plane3.h"
+
+typedef enum {
+    FrustumLeft,
+    FrustumRight,
+    FrustumBottom,
+    FrustumTop,
+    FrustumNear,
+    FrustumFar
+} FrustumPlane;
+
+/*
+ * The six planes of a view volume, normals pointing inside. Built from a
+ * view projection matrix (OpenGL clip space, -w <= x, y, z <= w), the planes
+ * are in the space the matrix maps from, usually world space.
+ *
+ * The tests are conservative: everything reported invisible is outside, but
+ * shapes near an edge of the frustum may be reported visible although they
+ * are not.
+ */
+class Frustum {
+    Plane3 _planes[6];
+    
+public:
+    Frustum();
+    explicit Frustum(const Matrix<float, 4, 4>& view_projection);
+    
+    const Plane3& plane(FrustumPlane p) const {
+        return _planes[p];
+    }
+    
+    bool sphere_visible(const Vector<float, 3>& center, float radius) const;
+    bool aabb_visible(const Vector<float, 3>& min, const Vector<float, 3>& max) const;
+    
+    /*
+     * visible[i] = sphere_visible((x[i], y[i], z[i]), radius[i]) as 0 or 1,
+     * four spheres per instruction.
+     */
+    void batch_spheres_visible(const float* x, const float* y, const float* z, const float* radius,
+                               unsigned char* visible, int count) const;
+    
+    /*
+     * visible[i] = aabb_visible((min_x[i], ...), (max_x[i], ...)) as 0 or 1.
+     */
+    void batch_aabbs_visible(const float* min_x, const float* min_y, const float* min_z,
+                             const float* max_x, const float* max_y, const float* max_z,
+                             unsigned char* visible, int count) const;
+};
+
+#endif /* defined(__game__Frustum__) */
@@ -0,0 +1,629 @@
+//
+//  Kernels.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "Kernels.h"
+#include <algorithm>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+// The kernel sets only stay bit identical if no multiply-add gets fused.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+static_assert(sizeof(Vector<float, 4>) == 4 * sizeof(float), "Vector4 arrays have to be tightly packed.");
+static_assert(sizeof(Matrix<float, 4, 4>) == 16 * sizeof(float), "Matrix4 arrays have to be tightly packed.");
+
+// the arrays of a batch_transform_points call
+struct PointArrays {
+    const float* x;
+    const float* y;
+    const float* z;
+    float* out_x;
+    float* out_y;
+    float* out_z;
+    float* out_w;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// scalar
+
+static void transform_scalar(const float* m, const float* in, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        float x = in[4 * i + 0];
+        float y = in[4 * i + 1];
+        float z = in[4 * i + 2];
+        float w = in[4 * i + 3];
+        out[4 * i + 0] = m[0] * x + m[4] * y + m[8]  * z + m[12] * w;
+        out[4 * i + 1] = m[1] * x + m[5] * y + m[9]  * z + m[13] * w;
+        out[4 * i + 2] = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+        out[4 * i + 3] = m[3] * x + m[7] * y + m[11] * z + m[15] * w;
+    }
+}
+
+static void multiply_scalar(const float* a, const float* b, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        float m[16];
+        std::copy(a + 16 * i, a + 16 * (i + 1), m); // out may alias a
+        transform_scalar(m, b + 16 * i, out + 16 * i, 4);
+    }
+}
+
+// Points i to count. The sum runs in the same order as Matrix4 * Vector4 with
+// w = 1 (m[12] * 1 is exact), so the results match the single point path.
+static void transform_points_scalar(const float* m, const PointArrays& p, int i, int count, PerspectiveMode mode) {
+    for (; i < count; ++i) {
+        float x = p.x[i];
+        float y = p.y[i];
+        float z = p.z[i];
+        float rx = m[0] * x + m[4] * y + m[8]  * z + m[12];
+        float ry = m[1] * x + m[5] * y + m[9]  * z + m[13];
+        float rz = m[2] * x + m[6] * y + m[10] * z + m[14];
+        float rw = m[3] * x + m[7] * y + m[11] * z + m[15];
+        if (mode != PerspectiveNone) {
+            float w = mode == PerspectiveDivideAbsolute ? fabsf(rw) : rw;
+            rx /= w;
+            ry /= w;
+            rz /= w;
+        }
+        p.out_x[i] = rx;
+        p.out_y[i] = ry;
+        if (p.out_z) p.out_z[i] = rz;
+        if (p.out_w) p.out_w[i] = rw;
+    }
+}
+
+static void dot_scalar(const float* a, const float* b, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        const float* u = a + 4 * i;
+        const float* v = b + 4 * i;
+        out[i] = u[0] * v[0] + u[1] * v[1] + u[2] * v[2] + u[3] * v[3];
+    }
+}
+
+static inline float extent(const float* x, const float* y, int i, float dx, float dy) {
+    return dx * x[i] + dy * y[i];
+}
+
+static int extreme_point_scalar(const float* x, const float* y, int count, float dx, float dy) {
+    int best = 0;
+    float best_extent = extent(x, y, 0, dx, dy);
+    for (int i = 1; i < count; ++i) {
+        float e = extent(x, y, i, dx, dy);
+        if (e > best_extent) {
+            best_extent = e;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// the best of the lanes' extreme points, the first one on ties
+static int reduce_extreme(const float* extents, const int* indices, int lanes) {
+    int best = 0;
+    for (int l = 1; l < lanes; ++l) {
+        if (extents[l] > extents[best] || (extents[l] == extents[best] && indices[l] < indices[best])) {
+            best = l;
+        }
+    }
+    return indices[best];
+}
+
+// the extreme point of the first i points or of the rest, rest counted from i
+static int merge_extreme(const float* x, const float* y, int i, int best, int rest, float dx, float dy) {
+    return extent(x, y, i + rest, dx, dy) > extent(x, y, best, dx, dy) ? i + rest : best;
+}
+
+#ifdef KERNELS_X86
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2, one vector per iteration
+
+static void transform_sse2(const float* m, const float* in, float* out, int count) {
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    for (int i = 0; i < count; ++i) {
+        __m128 v = _mm_loadu_ps(in + 4 * i);
+        __m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+        r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+        _mm_storeu_ps(out + 4 * i, r);
+    }
+}
+
+static void multiply_sse2(const float* a, const float* b, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        transform_sse2(a + 16 * i, b + 16 * i, out + 16 * i, 4);
+    }
+}
+
+static void transform_points_sse2(const float* m, const PointArrays& p, int i, int count, PerspectiveMode mode) {
+    __m128 sign = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(p.x + i);
+        __m128 y = _mm_loadu_ps(p.y + i);
+        __m128 z = _mm_loadu_ps(p.z + i);
+        __m128 r[4];
+        for (int j = 0; j < 4; ++j) {
+            r[j] = _mm_mul_ps(_mm_set1_ps(m[j]), x);
+            r[j] = _mm_add_ps(r[j], _mm_mul_ps(_mm_set1_ps(m[j + 4]), y));
+            r[j] = _mm_add_ps(r[j], _mm_mul_ps(_mm_set1_ps(m[j + 8]), z));
+            r[j] = _mm_add_ps(r[j], _mm_set1_ps(m[j + 12]));
+        }
+        if (mode != PerspectiveNone) {
+            __m128 w = mode == PerspectiveDivideAbsolute ? _mm_andnot_ps(sign, r[3]) : r[3];
+            r[0] = _mm_div_ps(r[0], w);
+            r[1] = _mm_div_ps(r[1], w);
+            r[2] = _mm_div_ps(r[2], w);
+        }
+        _mm_storeu_ps(p.out_x + i, r[0]);
+        _mm_storeu_ps(p.out_y + i, r[1]);
+        if (p.out_z) _mm_storeu_ps(p.out_z + i, r[2]);
+        if (p.out_w) _mm_storeu_ps(p.out_w + i, r[3]);
+    }
+    transform_points_scalar(m, p, i, count, mode);
+}
+
+static void dot_sse2(const float* a, const float* b, float* out, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 a0 = _mm_loadu_ps(a + 4 * i + 0);
+        __m128 a1 = _mm_loadu_ps(a + 4 * i + 4);
+        __m128 a2 = _mm_loadu_ps(a + 4 * i + 8);
+        __m128 a3 = _mm_loadu_ps(a + 4 * i + 12);
+        __m128 b0 = _mm_loadu_ps(b + 4 * i + 0);
+        __m128 b1 = _mm_loadu_ps(b + 4 * i + 4);
+        __m128 b2 = _mm_loadu_ps(b + 4 * i + 8);
+        __m128 b3 = _mm_loadu_ps(b + 4 * i + 12);
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+        __m128 r = _mm_mul_ps(a0, b0);
+        r = _mm_add_ps(r, _mm_mul_ps(a1, b1));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, b2));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, b3));
+        _mm_storeu_ps(out + i, r);
+    }
+    dot_scalar(a + 4 * i, b + 4 * i, out + i, count - i);
+}
+
+static int extreme_point_sse2(const float* x, const float* y, int count, float dx, float dy) {
+    if (count < 8) {
+        return extreme_point_scalar(x, y, count, dx, dy);
+    }
+    __m128 vdx = _mm_set1_ps(dx);
+    __m128 vdy = _mm_set1_ps(dy);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i step = _mm_set1_epi32(4);
+    __m128 best = _mm_add_ps(_mm_mul_ps(vdx, _mm_loadu_ps(x)), _mm_mul_ps(vdy, _mm_loadu_ps(y)));
+    __m128i best_index = index;
+    int i = 4;
+    for (; i + 4 <= count; i += 4) {
+        index = _mm_add_epi32(index, step);
+        __m128 e = _mm_add_ps(_mm_mul_ps(vdx, _mm_loadu_ps(x + i)), _mm_mul_ps(vdy, _mm_loadu_ps(y + i)));
+        __m128 greater = _mm_cmpgt_ps(e, best);
+        __m128i take = _mm_castps_si128(greater);
+        best = _mm_or_ps(_mm_and_ps(greater, e), _mm_andnot_ps(greater, best));
+        best_index = _mm_or_si128(_mm_and_si128(take, index), _mm_andnot_si128(take, best_index));
+    }
+    float extents[4];
+    int indices[4];
+    _mm_storeu_ps(extents, best);
+    _mm_storeu_si128((__m128i*)indices, best_index);
+    int result = reduce_extreme(extents, indices, 4);
+    if (i == count) return result;
+    return merge_extreme(x, y, i, result, extreme_point_scalar(x + i, y + i, count - i, dx, dy), dx, dy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2, two vectors per iteration (one per 128 bit lane)
+
+__attribute__((target("avx2")))
+static void transform_avx2(const float* m, const float* in, float* out, int count) {
+    __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 0));
+    __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+    __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+    __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m256 v = _mm256_loadu_ps(in + 4 * i);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(v, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permute_ps(v, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(v, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_permute_ps(v, 0xFF)));
+        _mm256_storeu_ps(out + 4 * i, r);
+    }
+    if (i < count) {
+        transform_sse2(m, in + 4 * i, out + 4 * i, count - i);
+    }
+}
+
+__attribute__((target("avx2")))
+static void multiply_avx2(const float* a, const float* b, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        transform_avx2(a + 16 * i, b + 16 * i, out + 16 * i, 4);
+    }
+}
+
+__attribute__((target("avx2")))
+static void transform_points_avx2(const float* m, const PointArrays& p, int i, int count, PerspectiveMode mode) {
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(p.x + i);
+        __m256 y = _mm256_loadu_ps(p.y + i);
+        __m256 z = _mm256_loadu_ps(p.z + i);
+        __m256 r[4];
+        for (int j = 0; j < 4; ++j) {
+            r[j] = _mm256_mul_ps(_mm256_set1_ps(m[j]), x);
+            r[j] = _mm256_add_ps(r[j], _mm256_mul_ps(_mm256_set1_ps(m[j + 4]), y));
+            r[j] = _mm256_add_ps(r[j], _mm256_mul_ps(_mm256_set1_ps(m[j + 8]), z));
+            r[j] = _mm256_add_ps(r[j], _mm256_set1_ps(m[j + 12]));
+        }
+        if (mode != PerspectiveNone) {
+            __m256 w = mode == PerspectiveDivideAbsolute ? _mm256_andnot_ps(sign, r[3]) : r[3];
+            r[0] = _mm256_div_ps(r[0], w);
+            r[1] = _mm256_div_ps(r[1], w);
+            r[2] = _mm256_div_ps(r[2], w);
+        }
+        _mm256_storeu_ps(p.out_x + i, r[0]);
+        _mm256_storeu_ps(p.out_y + i, r[1]);
+        if (p.out_z) _mm256_storeu_ps(p.out_z + i, r[2]);
+        if (p.out_w) _mm256_storeu_ps(p.out_w + i, r[3]);
+    }
+    transform_points_sse2(m, p, i, count, mode);
+}
+
+// 4x4 transpose inside each 128 bit lane
+__attribute__((target("avx2")))
+static inline void transpose_avx2(__m256& r0, __m256& r1, __m256& r2, __m256& r3) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+// vectors i and i+4 of the block end up in the same register
+__attribute__((target("avx2")))
+static inline __m256 load_pair_avx2(const float* p) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 16), 1);
+}
+
+__attribute__((target("avx2")))
+static void dot_avx2(const float* a, const float* b, float* out, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a0 = load_pair_avx2(a + 4 * i + 0);
+        __m256 a1 = load_pair_avx2(a + 4 * i + 4);
+        __m256 a2 = load_pair_avx2(a + 4 * i + 8);
+        __m256 a3 = load_pair_avx2(a + 4 * i + 12);
+        __m256 b0 = load_pair_avx2(b + 4 * i + 0);
+        __m256 b1 = load_pair_avx2(b + 4 * i + 4);
+        __m256 b2 = load_pair_avx2(b + 4 * i + 8);
+        __m256 b3 = load_pair_avx2(b + 4 * i + 12);
+        transpose_avx2(a0, a1, a2, a3);
+        transpose_avx2(b0, b1, b2, b3);
+        __m256 r = _mm256_mul_ps(a0, b0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(a1, b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a2, b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a3, b3));
+        _mm256_storeu_ps(out + i, r);
+    }
+    dot_sse2(a + 4 * i, b + 4 * i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static int extreme_point_avx2(const float* x, const float* y, int count, float dx, float dy) {
+    if (count < 16) {
+        return extreme_point_sse2(x, y, count, dx, dy);
+    }
+    __m256 vdx = _mm256_set1_ps(dx);
+    __m256 vdy = _mm256_set1_ps(dy);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i step = _mm256_set1_epi32(8);
+    __m256 best = _mm256_add_ps(_mm256_mul_ps(vdx, _mm256_loadu_ps(x)), _mm256_mul_ps(vdy, _mm256_loadu_ps(y)));
+    __m256i best_index = index;
+    int i = 8;
+    for (; i + 8 <= count; i += 8) {
+        index = _mm256_add_epi32(index, step);
+        __m256 e = _mm256_add_ps(_mm256_mul_ps(vdx, _mm256_loadu_ps(x + i)), _mm256_mul_ps(vdy, _mm256_loadu_ps(y + i)));
+        __m256 greater = _mm256_cmp_ps(e, best, _CMP_GT_OQ);
+        best = _mm256_blendv_ps(best, e, greater);
+        best_index = _mm256_blendv_epi8(best_index, index, _mm256_castps_si256(greater));
+    }
+    float extents[8];
+    int indices[8];
+    _mm256_storeu_ps(extents, best);
+    _mm256_storeu_si256((__m256i*)indices, best_index);
+    int result = reduce_extreme(extents, indices, 8);
+    if (i == count) return result;
+    return merge_extreme(x, y, i, result, extreme_point_sse2(x + i, y + i, count - i, dx, dy), dx, dy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX-512, four vectors per iteration (one per 128 bit lane)
+
+__attribute__((target("avx512f")))
+static void transform_avx512(const float* m, const float* in, float* out, int count) {
+    __m512 c0 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 0));
+    __m512 c1 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 4));
+    __m512 c2 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 8));
+    __m512 c3 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 12));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m512 v = _mm512_loadu_ps(in + 4 * i);
+        __m512 r = _mm512_mul_ps(c0, _mm512_permute_ps(v, 0x00));
+        r = _mm512_add_ps(r, _mm512_mul_ps(c1, _mm512_permute_ps(v, 0x55)));
+        r = _mm512_add_ps(r, _mm512_mul_ps(c2, _mm512_permute_ps(v, 0xAA)));
+        r = _mm512_add_ps(r, _mm512_mul_ps(c3, _mm512_permute_ps(v, 0xFF)));
+        _mm512_storeu_ps(out + 4 * i, r);
+    }
+    if (i < count) {
+        transform_avx2(m, in + 4 * i, out + 4 * i, count - i);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void multiply_avx512(const float* a, const float* b, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        transform_avx512(a + 16 * i, b + 16 * i, out + 16 * i, 4);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void transform_points_avx512(const float* m, const PointArrays& p, int i, int count, PerspectiveMode mode) {
+    for (; i + 16 <= count; i += 16) {
+        __m512 x = _mm512_loadu_ps(p.x + i);
+        __m512 y = _mm512_loadu_ps(p.y + i);
+        __m512 z = _mm512_loadu_ps(p.z + i);
+        __m512 r[4];
+        for (int j = 0; j < 4; ++j) {
+            r[j] = _mm512_mul_ps(_mm512_set1_ps(m[j]), x);
+            r[j] = _mm512_add_ps(r[j], _mm512_mul_ps(_mm512_set1_ps(m[j + 4]), y));
+            r[j] = _mm512_add_ps(r[j], _mm512_mul_ps(_mm512_set1_ps(m[j + 8]), z));
+            r[j] = _mm512_add_ps(r[j], _mm512_set1_ps(m[j + 12]));
+        }
+        if (mode != PerspectiveNone) {
+            __m512 w = mode == PerspectiveDivideAbsolute ? _mm512_abs_ps(r[3]) : r[3];
+            r[0] = _mm512_div_ps(r[0], w);
+            r[1] = _mm512_div_ps(r[1], w);
+            r[2] = _mm512_div_ps(r[2], w);
+        }
+        _mm512_storeu_ps(p.out_x + i, r[0]);
+        _mm512_storeu_ps(p.out_y + i, r[1]);
+        if (p.out_z) _mm512_storeu_ps(p.out_z + i, r[2]);
+        if (p.out_w) _mm512_storeu_ps(p.out_w + i, r[3]);
+    }
+    transform_points_avx2(m, p, i, count, mode);
+}
+
+__attribute__((target("avx512f")))
+static inline void transpose_avx512(__m512& r0, __m512& r1, __m512& r2, __m512& r3) {
+    __m512 t0 = _mm512_unpacklo_ps(r0, r1);
+    __m512 t1 = _mm512_unpackhi_ps(r0, r1);
+    __m512 t2 = _mm512_unpacklo_ps(r2, r3);
+    __m512 t3 = _mm512_unpackhi_ps(r2, r3);
+    r0 = _mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+// vectors i, i+4, i+8 and i+12 of the block end up in the same register
+__attribute__((target("avx512f")))
+static inline __m512 load_quad_avx512(const float* p) {
+    __m512 r = _mm512_castps128_ps512(_mm_loadu_ps(p));
+    r = _mm512_insertf32x4(r, _mm_loadu_ps(p + 16), 1);
+    r = _mm512_insertf32x4(r, _mm_loadu_ps(p + 32), 2);
+    return _mm512_insertf32x4(r, _mm_loadu_ps(p + 48), 3);
+}
+
+__attribute__((target("avx512f")))
+static void dot_avx512(const float* a, const float* b, float* out, int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 a0 = load_quad_avx512(a + 4 * i + 0);
+        __m512 a1 = load_quad_avx512(a + 4 * i + 4);
+        __m512 a2 = load_quad_avx512(a + 4 * i + 8);
+        __m512 a3 = load_quad_avx512(a + 4 * i + 12);
+        __m512 b0 = load_quad_avx512(b + 4 * i + 0);
+        __m512 b1 = load_quad_avx512(b + 4 * i + 4);
+        __m512 b2 = load_quad_avx512(b + 4 * i + 8);
+        __m512 b3 = load_quad_avx512(b + 4 * i + 12);
+        transpose_avx512(a0, a1, a2, a3);
+        transpose_avx512(b0, b1, b2, b3);
+        __m512 r = _mm512_mul_ps(a0, b0);
+        r = _mm512_add_ps(r, _mm512_mul_ps(a1, b1));
+        r = _mm512_add_ps(r, _mm512_mul_ps(a2, b2));
+        r = _mm512_add_ps(r, _mm512_mul_ps(a3, b3));
+        _mm512_storeu_ps(out + i, r);
+    }
+    dot_avx2(a + 4 * i, b + 4 * i, out + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+static int extreme_point_avx512(const float* x, const float* y, int count, float dx, float dy) {
+    if (count < 32) {
+        return extreme_point_avx2(x, y, count, dx, dy);
+    }
+    __m512 vdx = _mm512_set1_ps(dx);
+    __m512 vdy = _mm512_set1_ps(dy);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i step = _mm512_set1_epi32(16);
+    __m512 best = _mm512_add_ps(_mm512_mul_ps(vdx, _mm512_loadu_ps(x)), _mm512_mul_ps(vdy, _mm512_loadu_ps(y)));
+    __m512i best_index = index;
+    int i = 16;
+    for (; i + 16 <= count; i += 16) {
+        index = _mm512_add_epi32(index, step);
+        __m512 e = _mm512_add_ps(_mm512_mul_ps(vdx, _mm512_loadu_ps(x + i)), _mm512_mul_ps(vdy, _mm512_loadu_ps(y + i)));
+        __mmask16 greater = _mm512_cmp_ps_mask(e, best, _CMP_GT_OQ);
+        best = _mm512_mask_blend_ps(greater, best, e);
+        best_index = _mm512_mask_blend_epi32(greater, best_index, index);
+    }
+    float extents[16];
+    int indices[16];
+    _mm512_storeu_ps(extents, best);
+    _mm512_storeu_si512(indices, best_index);
+    int result = reduce_extreme(extents, indices, 16);
+    if (i == count) return result;
+    return merge_extreme(x, y, i, result, extreme_point_avx2(x + i, y + i, count - i, dx, dy), dx, dy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// cpu detection
+
+static unsigned long long xgetbv0() {
+    unsigned int eax, edx;
+    __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+}
+
+static bool os_supports_avx512(unsigned long long xcr0) {
+#if defined(__APPLE__)
+    // Darwin enables the AVX-512 register state lazily, so XCR0 does not
+    // report it before the first AVX-512 instruction. Ask the kernel instead.
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname("hw.optional.avx512f", &value, &size, 0, 0) == 0) {
+        return value != 0;
+    }
+#endif
+    // xmm, ymm, opmask and both halves of the zmm registers
+    return (xcr0 & 0xE6) == 0xE6;
+}
+
+#endif // KERNELS_X86
+
+static KernelSet detect_kernel_set() {
+#ifdef KERNELS_X86
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(edx & bit_SSE2)) {
+        return KernelScalar;
+    }
+    if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX) || __get_cpuid_max(0, 0) < 7) {
+        return KernelSSE2;
+    }
+    unsigned long long xcr0 = xgetbv0();
+    if ((xcr0 & 0x6) != 0x6) { // xmm and ymm state
+        return KernelSSE2;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    if (!(ebx & bit_AVX2)) {
+        return KernelSSE2;
+    }
+    if (!(ebx & bit_AVX512F) || !os_supports_avx512(xcr0)) {
+        return KernelAVX2;
+    }
+    return KernelAVX512;
+#else
+    return KernelScalar;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// dispatch
+
+struct KernelTable {
+    KernelSet set;
+    void (*transform)(const float* m, const float* in, float* out, int count);
+    void (*multiply)(const float* a, const float* b, float* out, int count);
+    void (*dot)(const float* a, const float* b, float* out, int count);
+    void (*transform_points)(const float* m, const PointArrays& p, int i, int count, PerspectiveMode mode);
+    int (*extreme_point)(const float* x, const float* y, int count, float dx, float dy);
+};
+
+static KernelTable make_kernel_table(KernelSet set) {
+    switch (set) {
+#ifdef KERNELS_X86
+        case KernelAVX512:
+            return KernelTable{set, transform_avx512, multiply_avx512, dot_avx512, transform_points_avx512, extreme_point_avx512};
+        case KernelAVX2:
+            return KernelTable{set, transform_avx2, multiply_avx2, dot_avx2, transform_points_avx2, extreme_point_avx2};
+        case KernelSSE2:
+            return KernelTable{set, transform_sse2, multiply_sse2, dot_sse2, transform_points_sse2, extreme_point_sse2};
+#endif
+        default:
+            return KernelTable{KernelScalar, transform_scalar, multiply_scalar, dot_scalar, transform_points_scalar, extreme_point_scalar};
+    }
+}
+
+static KernelTable& kernel_table() {
+    static KernelTable table = make_kernel_table(supported_kernel_set());
+    return table;
+}
+
+KernelSet supported_kernel_set() {
+    static KernelSet supported = detect_kernel_set();
+    return supported;
+}
+
+KernelSet active_kernel_set() {
+    return kernel_table().set;
+}
+
+KernelSet select_kernel_set(KernelSet set) {
+    if (set > supported_kernel_set()) {
+        set = supported_kernel_set();
+    }
+    kernel_table() = make_kernel_table(set);
+    return kernel_table().set;
+}
+
+const char* kernel_set_name(KernelSet set) {
+    switch (set) {
+        case KernelScalar: return "scalar";
+        case KernelSSE2: return "sse2";
+        case KernelAVX2: return "avx2";
+        case KernelAVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+void batch_transform(const Matrix<float, 4, 4>& m, const Vector<float, 4>* in, Vector<float, 4>* out, int count) {
+    if (count <= 0) return;
+    kernel_table().transform(m.data, in->data, out->data, count);
+}
+
+void batch_multiply(const Matrix<float, 4, 4>* a, const Matrix<float, 4, 4>* b, Matrix<float, 4, 4>* out, int count) {
+    if (count <= 0) return;
+    kernel_table().multiply(a->data, b->data, out->data, count);
+}
+
+void batch_dot(const Vector<float, 4>* a, const Vector<float, 4>* b, float* out, int count) {
+    if (count <= 0) return;
+    kernel_table().dot(a->data, b->data, out, count);
+}
+
+void batch_transform_points(const Matrix<float, 4, 4>& m,
+                            const float* x, const float* y, const float* z,
+                            float* out_x, float* out_y, float* out_z, float* out_w,
+                            int count, PerspectiveMode mode) {
+    if (count <= 0) return;
+    PointArrays p = {x, y, z, out_x, out_y, out_z, out_w};
+    kernel_table().transform_points(m.data, p, 0, count, mode);
+}
+
+int batch_extreme_point(const float* x, const float* y, int count, float dx, float dy) {
+    if (count <= 0) return -1;
+    return kernel_table().extreme_point(x, y, count, dx, dy);
+}
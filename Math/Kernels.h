@@ -0,0 +1,87 @@
+//
+//  Kernels.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __game__Kernels__
+#define __game__Kernels__
+
+#include "Vector4.h"
+#include "Matrix4.h"
+
+/*
+ * Batch kernels with runtime cpu dispatch. The best instruction set the cpu
+ * (and operating system) supports is picked once, on first use. All kernel
+ * sets produce bit identical results.
+ */
+typedef enum {
+    KernelScalar,
+    KernelSSE2,
+    KernelAVX2,
+    KernelAVX512
+} KernelSet;
+
+/*
+ * What batch_transform_points does with the homogeneous coordinate.
+ */
+typedef enum {
+    PerspectiveNone,            // keep x, y, z as they are
+    PerspectiveDivide,          // divide x, y, z by w
+    PerspectiveDivideAbsolute   // divide x, y, z by |w|, points behind the eye are not mirrored
+} PerspectiveMode;
+
+/*
+ * The highest kernel set this machine can run.
+ */
+KernelSet supported_kernel_set();
+
+/*
+ * The kernel set the batch functions currently use.
+ */
+KernelSet active_kernel_set();
+
+/*
+ * Use the given kernel set (limited to what the machine supports) for all
+ * following batch calls. Returns the set that is active afterwards.
+ */
+KernelSet select_kernel_set(KernelSet set);
+
+const char* kernel_set_name(KernelSet set);
+
+/*
+ * out[i] = m * in[i]. in and out may be the same array.
+ */
+void batch_transform(const Matrix<float, 4, 4>& m, const Vector<float, 4>* in, Vector<float, 4>* out, int count);
+
+/*
+ * Transforms the points (x[i], y[i], z[i], 1) by m. The points are stored as
+ * separate coordinate arrays, which lets every kernel set process a full
+ * register of points per instruction. out_z and out_w may be null if they are
+ * not needed; out_w always receives the w before the divide. The output arrays
+ * may be the same as the input arrays.
+ */
+void batch_transform_points(const Matrix<float, 4, 4>& m,
+                            const float* x, const float* y, const float* z,
+                            float* out_x, float* out_y, float* out_z, float* out_w,
+                            int count, PerspectiveMode mode);
+
+/*
+ * out[i] = a[i] * b[i]. out may alias a or b.
+ */
+void batch_multiply(const Matrix<float, 4, 4>* a, const Matrix<float, 4, 4>* b, Matrix<float, 4, 4>* out, int count);
+
+/*
+ * out[i] = dot(a[i], b[i]).
+ */
+void batch_dot(const Vector<float, 4>* a, const Vector<float, 4>* b, float* out, int count);
+
+/*
+ * The index of the point (x[i], y[i]) that is furthest in the direction
+ * (dx, dy), by dx * x[i] + dy * y[i], the smallest index of equally far
+ * points; -1 without points.
+ */
+int batch_extreme_point(const float* x, const float* y, int count, float dx, float dy);
+
+#endif /* defined(__game__Kernels__) */
@@ -9,11 +9,11 @@
 #include "Math.h"
 
 void random_seed(unsigned int seed) {
-    srand(seed);
+    reseed_thread_random_streams(seed);
 }
 
 int random(int from, int to) {
-    return rand() % (to - from + 1) + from;
+    return thread_random_stream().range(from, to);
 }
 
 Matrix<float, 4, 4> perspective_projection(int width, int height, float field_of_view, float znear, float zfar) {
@@ -55,10 +55,13 @@ Matrix<float, 4, 4> orthogonal_projection(float left, float right, float bottom,
 }
 
 Matrix<float, 3, 3> normal_matrix(const Matrix<float, 4, 4>& model_view_matrix) {
-    Matrix<float, 4, 4> result = transpose(inverse(model_view_matrix));
-    return Matrix<float, 3, 3>(result(0,0), result(0,1), result(0,2),
-                               result(1,0), result(1,1), result(1,2),
-                               result(2,0), result(2,1), result(2,2));
+    // the inverse transpose of the upper 3x3 block is its cofactor matrix / det
+    const Matrix<float, 4, 4>& a = model_view_matrix;
+    Matrix<float, 3, 3> cofactors(a(1,1) * a(2,2) - a(1,2) * a(2,1), a(1,2) * a(2,0) - a(1,0) * a(2,2), a(1,0) * a(2,1) - a(1,1) * a(2,0),
+                                  a(0,2) * a(2,1) - a(0,1) * a(2,2), a(0,0) * a(2,2) - a(0,2) * a(2,0), a(0,1) * a(2,0) - a(0,0) * a(2,1),
+                                  a(0,1) * a(1,2) - a(0,2) * a(1,1), a(0,2) * a(1,0) - a(0,0) * a(1,2), a(0,0) * a(1,1) - a(0,1) * a(1,0));
+    float det = a(0,0) * cofactors(0,0) + a(0,1) * cofactors(0,1) + a(0,2) * cofactors(0,2);
+    return cofactors / det;
 }
 
 Matrix<float, 4, 4> look_at(const Vector<float, 3> at, const Vector<float, 3> eye, const Vector<float, 3> up) {
@@ -15,14 +15,21 @@
 #include "Vector2.h"
 #include "Vector3.h"
 #include "Vector4.h"
+#include "VectorExpression.h"
 
 #include "Matrix.h"
 #include "Matrix2.h"
 #include "Matrix3.h"
 #include "Matrix4.h"
 
+#include "SIMD.h"
+
 #include "Quaternion.h"
 
+#include "FastTrigonometry.h"
+
+#include "Random.h"
+
 #include <math.h>
 
 /*template <typename Type>
@@ -71,7 +78,7 @@ template <typename T> int sign(T val) {
     return (T(0) < val) - (val < T(0));
 }
 
-// random
+// random, per thread streams, see Random.h
 void random_seed(unsigned int seed);
 int random(int from, int to);
 
@@ -84,47 +91,44 @@ Matrix<float, 3, 3> normal_matrix(const Matrix<float, 4, 4>& model_view_matrix);
 Matrix<float, 4, 4> look_at(const Vector<float, 3> at, const Vector<float, 3> eye, const Vector<float, 3> up);
 
 // Transformation
+
+// The rotation matrices from the pairwise products of the quaternion elements.
 template<typename Type>
-Matrix<Type, 3, 3> rotation(const Quaternion<Type>& q) {
-    Type data_0_1 = q.data[0] * q.data[1];
-    Type data_0_2 = q.data[0] * q.data[2];
-    Type data_0_3 = q.data[0] * q.data[3];
-    
-    Type data_1_1 = q.data[1] * q.data[1];
-    Type data_1_2 = q.data[1] * q.data[2];
-    Type data_1_3 = q.data[1] * q.data[3];
-    
-    Type data_2_2 = q.data[2] * q.data[2];
-    Type data_2_3 = q.data[2] * q.data[3];
-    
-    Type data_3_3 = q.data[3] * q.data[3];
+constexpr Matrix<Type, 3, 3> rotation(const Type& data_0_1, const Type& data_0_2, const Type& data_0_3,
+                                      const Type& data_1_1, const Type& data_1_2, const Type& data_1_3,
+                                      const Type& data_2_2, const Type& data_2_3, const Type& data_3_3) {
     return Matrix<Type, 3, 3>{1.0 - 2.0 * (data_2_2 + data_3_3), 2.0 * (data_1_2 - data_0_3),       2.0 * (data_1_3 + data_0_2),
                               2.0 * (data_1_2 + data_0_3),       1.0 - 2.0 * (data_1_1 + data_3_3), 2.0 * (data_2_3 - data_0_1),
                               2.0 * (data_1_3 - data_0_2),       2.0 * (data_2_3 + data_0_1),       1.0 - 2.0 * (data_1_1 + data_2_2)};
 }
 template<typename Type>
-Matrix<Type, 4, 4> homogeneous_rotation(const Quaternion<Type>& q) {
-    Type data_0_1 = q.data[0] * q.data[1];
-    Type data_0_2 = q.data[0] * q.data[2];
-    Type data_0_3 = q.data[0] * q.data[3];
-    
-    Type data_1_1 = q.data[1] * q.data[1];
-    Type data_1_2 = q.data[1] * q.data[2];
-    Type data_1_3 = q.data[1] * q.data[3];
-    
-    Type data_2_2 = q.data[2] * q.data[2];
-    Type data_2_3 = q.data[2] * q.data[3];
-    
-    Type data_3_3 = q.data[3] * q.data[3];
+constexpr Matrix<Type, 4, 4> homogeneous_rotation(const Type& data_0_1, const Type& data_0_2, const Type& data_0_3,
+                                                  const Type& data_1_1, const Type& data_1_2, const Type& data_1_3,
+                                                  const Type& data_2_2, const Type& data_2_3, const Type& data_3_3) {
     return Matrix<Type, 4, 4>{1.0 - 2.0 * (data_2_2 + data_3_3), 2.0 * (data_1_2 - data_0_3),       2.0 * (data_1_3 + data_0_2),       0.0,
                               2.0 * (data_1_2 + data_0_3),       1.0 - 2.0 * (data_1_1 + data_3_3), 2.0 * (data_2_3 - data_0_1),       0.0,
                               2.0 * (data_1_3 - data_0_2),       2.0 * (data_2_3 + data_0_1),       1.0 - 2.0 * (data_1_1 + data_2_2), 0.0,
                               0.0,                               0.0,                               0.0,                               1.0};
 }
 
+template<typename Type>
+constexpr Matrix<Type, 3, 3> rotation(const Quaternion<Type>& q) {
+    return rotation(q.data[0] * q.data[1], q.data[0] * q.data[2], q.data[0] * q.data[3],
+                    q.data[1] * q.data[1], q.data[1] * q.data[2], q.data[1] * q.data[3],
+                    q.data[2] * q.data[2], q.data[2] * q.data[3],
+                    q.data[3] * q.data[3]);
+}
+template<typename Type>
+constexpr Matrix<Type, 4, 4> homogeneous_rotation(const Quaternion<Type>& q) {
+    return homogeneous_rotation(q.data[0] * q.data[1], q.data[0] * q.data[2], q.data[0] * q.data[3],
+                                q.data[1] * q.data[1], q.data[1] * q.data[2], q.data[1] * q.data[3],
+                                q.data[2] * q.data[2], q.data[2] * q.data[3],
+                                q.data[3] * q.data[3]);
+}
+
 
 template<typename Type>
-Matrix<Type, 4, 4> homogeneous_translation(const Vector<Type, 3>& t) {
+constexpr Matrix<Type, 4, 4> homogeneous_translation(const Vector<Type, 3>& t) {
     return Matrix<Type, 4, 4>{1.0, 0.0, 0.0, t[0],
                               0.0, 1.0, 0.0, t[1],
                               0.0, 0.0, 1.0, t[2],
@@ -132,7 +136,7 @@ Matrix<Type, 4, 4> homogeneous_translation(const Vector<Type, 3>& t) {
 }
 
 template<typename Type>
-Matrix<Type, 4, 4> homogeneous_scale(const Vector<Type, 3>& s) {
+constexpr Matrix<Type, 4, 4> homogeneous_scale(const Vector<Type, 3>& s) {
     return Matrix<Type, 4, 4>{s[0], 0.0,  0.0,  0.0,
                               0.0,  s[1], 0.0,  0.0,
                               0.0,  0.0,  s[2], 0.0,
@@ -140,7 +144,7 @@ Matrix<Type, 4, 4> homogeneous_scale(const Vector<Type, 3>& s) {
 }
 
 template<typename Type>
-Vector<Type, 3> transformed_point(const Matrix<Type, 4, 4>& transformation, const Vector<Type, 3>& point) {
+constexpr Vector<Type, 3> transformed_point(const Matrix<Type, 4, 4>& transformation, const Vector<Type, 3>& point) {
     return Vector<Type, 3> {
         transformation(0,0) * point[0] + transformation(0,1) * point[1] + transformation(0,2) * point[2] + transformation(0,3),
         transformation(1,0) * point[0] + transformation(1,1) * point[1] + transformation(1,2) * point[2] + transformation(1,3),
@@ -149,7 +153,7 @@ Vector<Type, 3> transformed_point(const Matrix<Type, 4, 4>& transformation, cons
 }
 
 template<typename Type>
-Vector<Type, 3> transformed_vector(const Matrix<Type, 4, 4>& transformation, const Vector<Type, 3>& vector) {
+constexpr Vector<Type, 3> transformed_vector(const Matrix<Type, 4, 4>& transformation, const Vector<Type, 3>& vector) {
     return Vector<Type, 3> {
         transformation(0,0) * vector[0] + transformation(0,1) * vector[1] + transformation(0,2) * vector[2],
         transformation(1,0) * vector[0] + transformation(1,1) * vector[1] + transformation(1,2) * vector[2],
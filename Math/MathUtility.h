@@ -33,4 +33,31 @@ Type atan(const Type& v);
 template<typename Type>
 Type atan2(const Type& y, const Type& x);
 
+/*
+ * sin and cos for constant expressions, e.g. tables that are built at compile
+ * time. They evaluate a taylor series in double precision after reducing the
+ * argument to [-PI, PI]; use the regular functions at runtime.
+ */
+constexpr double constant_floor(double v) {
+    return static_cast<double>(static_cast<long long>(v)) > v ? static_cast<double>(static_cast<long long>(v)) - 1.0
+                                                              : static_cast<double>(static_cast<long long>(v));
+}
+
+constexpr double constant_reduce(double v) {
+    return v - 2.0 * PI * constant_floor((v + PI) / (2.0 * PI));
+}
+
+// sum of the series terms from term on, x2 = x * x, k is the power of term
+constexpr double constant_series(double x2, double term, int k) {
+    return k > 40 ? 0.0 : term + constant_series(x2, -term * x2 / ((k + 1) * (k + 2)), k + 2);
+}
+
+constexpr double constant_sin(double v) {
+    return constant_series(constant_reduce(v) * constant_reduce(v), constant_reduce(v), 1);
+}
+
+constexpr double constant_cos(double v) {
+    return constant_series(constant_reduce(v) * constant_reduce(v), 1.0, 0);
+}
+
 #endif /* defined(__game__MathUtility__) */
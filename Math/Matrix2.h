@@ -18,17 +18,16 @@ struct Matrix<Type,2,2> {
     
     Type data[R * C];
     
-    Matrix() : Matrix{1, 0,
-                      0, 1} {}
-    explicit Matrix(const Type& t) : Matrix{t, 0,
-                                            0, t} {}
-    Matrix(const Type& m00, const Type& m01,
-           const Type& m10, const Type& m11) {
-        (*this)(0,0) = m00; (*this)(0,1) = m01;
-        (*this)(1,0) = m10; (*this)(1,1) = m11;
-    }
+    constexpr Matrix() : Matrix{1, 0,
+                                0, 1} {}
+    constexpr explicit Matrix(const Type& t) : Matrix{t, 0,
+                                                      0, t} {}
+    constexpr Matrix(const Type& m00, const Type& m01,
+                     const Type& m10, const Type& m11)
+        // stored column major
+        : data{m00, m10, m01, m11} {}
     
-    const Type& operator () (int row, int col) const {
+    constexpr const Type& operator () (int row, int col) const {
         return data[row + R * col];
     }
     Type& operator () (int row, int col) {
@@ -18,21 +18,19 @@ struct Matrix<Type,3,3> {
     
     Type data[R * C];
     
-    Matrix() : Matrix{1, 0, 0,
-                      0, 1, 0,
-                      0, 0, 1} {}
-    explicit Matrix(const Type& t) : Matrix{t, 0, 0,
-                                            0, t, 0,
-                                            0, 0, t} {}
-    Matrix(const Type& m00, const Type& m01, const Type& m02,
-           const Type& m10, const Type& m11, const Type& m12,
-           const Type& m20, const Type& m21, const Type& m22) {
-        (*this)(0,0) = m00; (*this)(0,1) = m01; (*this)(0,2) = m02;
-        (*this)(1,0) = m10; (*this)(1,1) = m11; (*this)(1,2) = m12;
-        (*this)(2,0) = m20; (*this)(2,1) = m21; (*this)(2,2) = m22;
-    }
+    constexpr Matrix() : Matrix{1, 0, 0,
+                                0, 1, 0,
+                                0, 0, 1} {}
+    constexpr explicit Matrix(const Type& t) : Matrix{t, 0, 0,
+                                                      0, t, 0,
+                                                      0, 0, t} {}
+    constexpr Matrix(const Type& m00, const Type& m01, const Type& m02,
+                     const Type& m10, const Type& m11, const Type& m12,
+                     const Type& m20, const Type& m21, const Type& m22)
+        // stored column major
+        : data{m00, m10, m20, m01, m11, m21, m02, m12, m22} {}
     
-    const Type& operator () (int row, int col) const {
+    constexpr const Type& operator () (int row, int col) const {
         return data[row + R * col];
     }
     Type& operator () (int row, int col) {
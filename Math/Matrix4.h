@@ -21,29 +21,26 @@ struct Matrix<Type,4,4> {
     /*
      * Create a identity matrix.
      */
-    Matrix() : Matrix{1, 0, 0, 0,
-                      0, 1, 0, 0,
-                      0, 0, 1, 0,
-                      0, 0, 0, 1} {}
+    constexpr Matrix() : Matrix{1, 0, 0, 0,
+                                0, 1, 0, 0,
+                                0, 0, 1, 0,
+                                0, 0, 0, 1} {}
     
     /*
      * Create a diagonal matrix and initialize the diagonal with t.
      */
-    explicit Matrix(const Type& t) : Matrix{t, 0, 0, 0,
-                                            0, t, 0, 0,
-                                            0, 0, t, 0,
-                                            0, 0, 0, t} {}
-    Matrix(const Type& m00, const Type& m01, const Type& m02, const Type& m03,
-           const Type& m10, const Type& m11, const Type& m12, const Type& m13,
-           const Type& m20, const Type& m21, const Type& m22, const Type& m23,
-           const Type& m30, const Type& m31, const Type& m32, const Type& m33) {
-        (*this)(0,0) = m00; (*this)(0,1) = m01; (*this)(0,2) = m02; (*this)(0,3) = m03;
-        (*this)(1,0) = m10; (*this)(1,1) = m11; (*this)(1,2) = m12; (*this)(1,3) = m13;
-        (*this)(2,0) = m20; (*this)(2,1) = m21; (*this)(2,2) = m22; (*this)(2,3) = m23;
-        (*this)(3,0) = m30; (*this)(3,1) = m31; (*this)(3,2) = m32; (*this)(3,3) = m33;
-    }
+    constexpr explicit Matrix(const Type& t) : Matrix{t, 0, 0, 0,
+                                                      0, t, 0, 0,
+                                                      0, 0, t, 0,
+                                                      0, 0, 0, t} {}
+    constexpr Matrix(const Type& m00, const Type& m01, const Type& m02, const Type& m03,
+                     const Type& m10, const Type& m11, const Type& m12, const Type& m13,
+                     const Type& m20, const Type& m21, const Type& m22, const Type& m23,
+                     const Type& m30, const Type& m31, const Type& m32, const Type& m33)
+        // stored column major
+        : data{m00, m10, m20, m30, m01, m11, m21, m31, m02, m12, m22, m32, m03, m13, m23, m33} {}
     
-    const Type& operator () (int row, int col) const {
+    constexpr const Type& operator () (int row, int col) const {
         return data[row + R * col];
     }
     Type& operator () (int row, int col) {
@@ -229,4 +226,44 @@ inline Matrix<Type,4,4> inverse(const Matrix<Type,4,4>& a) {
     return result;
 }
 
+/*
+ * Inverse of a rigid transformation, a rotation followed by a translation.
+ * The rotation is transposed and the translation rotated back, which is a lot
+ * cheaper than the general inverse. The last row has to be (0, 0, 0, 1).
+ */
+template<typename Type>
+inline Matrix<Type,4,4> rigid_inverse(const Matrix<Type,4,4>& a) {
+    return Matrix<Type,4,4>{a(0,0), a(1,0), a(2,0), -(a(0,0) * a(0,3) + a(1,0) * a(1,3) + a(2,0) * a(2,3)),
+                            a(0,1), a(1,1), a(2,1), -(a(0,1) * a(0,3) + a(1,1) * a(1,3) + a(2,1) * a(2,3)),
+                            a(0,2), a(1,2), a(2,2), -(a(0,2) * a(0,3) + a(1,2) * a(1,3) + a(2,2) * a(2,3)),
+                            0,      0,      0,      1};
+}
+
+/*
+ * Inverse of an affine transformation (rotation, scale, shear and translation).
+ * Only the upper 3x3 block is inverted; the last row has to be (0, 0, 0, 1).
+ */
+template<typename Type>
+inline Matrix<Type,4,4> affine_inverse(const Matrix<Type,4,4>& a) {
+    Type c00 = a(1,1) * a(2,2) - a(1,2) * a(2,1);
+    Type c01 = a(1,2) * a(2,0) - a(1,0) * a(2,2);
+    Type c02 = a(1,0) * a(2,1) - a(1,1) * a(2,0);
+    Type inv_det = static_cast<Type>(1) / (a(0,0) * c00 + a(0,1) * c01 + a(0,2) * c02);
+    
+    Type i00 = c00 * inv_det;
+    Type i01 = (a(0,2) * a(2,1) - a(0,1) * a(2,2)) * inv_det;
+    Type i02 = (a(0,1) * a(1,2) - a(0,2) * a(1,1)) * inv_det;
+    Type i10 = c01 * inv_det;
+    Type i11 = (a(0,0) * a(2,2) - a(0,2) * a(2,0)) * inv_det;
+    Type i12 = (a(0,2) * a(1,0) - a(0,0) * a(1,2)) * inv_det;
+    Type i20 = c02 * inv_det;
+    Type i21 = (a(0,1) * a(2,0) - a(0,0) * a(2,1)) * inv_det;
+    Type i22 = (a(0,0) * a(1,1) - a(0,1) * a(1,0)) * inv_det;
+    
+    return Matrix<Type,4,4>{i00, i01, i02, -(i00 * a(0,3) + i01 * a(1,3) + i02 * a(2,3)),
+                            i10, i11, i12, -(i10 * a(0,3) + i11 * a(1,3) + i12 * a(2,3)),
+                            i20, i21, i22, -(i20 * a(0,3) + i21 * a(1,3) + i22 * a(2,3)),
+                            0,   0,   0,   1};
+}
+
 #endif /* defined(__game__Matrix4__) */
@@ -53,6 +53,11 @@ public:
         return _d;
     }
     
+    // signed distance, positive on the side the normal points to
+    float distance(const Vector<float, 3>& point) const {
+        return dot(_normal, point) + _d;
+    }
+    
 };
 
 Vector<float, 3> intersection(const Plane3& p0, const Plane3& p1, const Plane3& p2);
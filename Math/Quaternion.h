@@ -17,13 +17,8 @@ template<typename Type>
 struct Quaternion {
     Type data[4];
     
-    Quaternion() : Quaternion{1, 0, 0, 0} {}
-    Quaternion(const Type& real, const Type& x, const Type& y, const Type& z) {
-        data[0] = real;
-        data[1] = x;
-        data[2] = y;
-        data[3] = z;
-    }
+    constexpr Quaternion() : Quaternion{1, 0, 0, 0} {}
+    constexpr Quaternion(const Type& real, const Type& x, const Type& y, const Type& z) : data{real, x, y, z} {}
     Quaternion(const Vector<Type,3>& axis_normal, const Type& angle) {
         Type cos_angle_2 = cos(angle * 0.5);
         Type sin_angle_2 = sin(angle * 0.5);
@@ -59,7 +54,7 @@ struct Quaternion {
         data[3] = (x[1] - y[0]) * w4_recip;
     }
     
-    const Type& operator[] (int i) const {
+    constexpr const Type& operator[] (int i) const {
         return data[i];
     }
     Type& operator[] (int i) {
@@ -106,7 +101,7 @@ struct Quaternion {
 };
 
 template<typename Type>
-Quaternion<Type> operator + (const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
+constexpr Quaternion<Type> operator + (const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
     return Quaternion<Type>{q0.data[0] + q1.data[0],
                             q0.data[1] + q1.data[1],
                             q0.data[2] + q1.data[2],
@@ -114,7 +109,7 @@ Quaternion<Type> operator + (const Quaternion<Type>& q0, const Quaternion<Type>&
 }
 
 template<typename Type>
-Quaternion<Type> operator - (const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
+constexpr Quaternion<Type> operator - (const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
     return Quaternion<Type>{q0.data[0] - q1.data[0],
                             q0.data[1] - q1.data[1],
                             q0.data[2] - q1.data[2],
@@ -122,7 +117,7 @@ Quaternion<Type> operator - (const Quaternion<Type>& q0, const Quaternion<Type>&
 }
 
 template<typename Type>
-Quaternion<Type> operator * (const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
+constexpr Quaternion<Type> operator * (const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
     return Quaternion<float>{q0.data[0] * q1.data[0] - q0.data[1] * q1.data[1] - q0.data[2] * q1.data[2] - q0.data[3] * q1.data[3],
                              q0.data[2] * q1.data[3] - q0.data[3] * q1.data[2] + q0.data[0] * q1.data[1] + q0.data[1] * q1.data[0],
                              q0.data[3] * q1.data[1] - q0.data[1] * q1.data[3] + q0.data[0] * q1.data[2] + q0.data[2] * q1.data[0],
@@ -130,7 +125,7 @@ Quaternion<Type> operator * (const Quaternion<Type>& q0, const Quaternion<Type>&
 }
 
 template<typename Type>
-Quaternion<Type> operator * (const Quaternion<Type>& q, const Type& s) {
+constexpr Quaternion<Type> operator * (const Quaternion<Type>& q, const Type& s) {
     return Quaternion<Type>{q.data[0] * s,
                             q.data[1] * s,
                             q.data[2] * s,
@@ -138,7 +133,7 @@ Quaternion<Type> operator * (const Quaternion<Type>& q, const Type& s) {
 }
 
 template<typename Type>
-Quaternion<Type> operator * (const Type& s, const Quaternion<Type>& q) {
+constexpr Quaternion<Type> operator * (const Type& s, const Quaternion<Type>& q) {
     return Quaternion<Type>{q.data[0] * s,
                             q.data[1] * s,
                             q.data[2] * s,
@@ -146,7 +141,7 @@ Quaternion<Type> operator * (const Type& s, const Quaternion<Type>& q) {
 }
 
 template<typename Type>
-Quaternion<Type> operator / (const Quaternion<Type>& q, const Type& s) {
+constexpr Quaternion<Type> operator / (const Quaternion<Type>& q, const Type& s) {
     return Quaternion<Type>{q.data[0] / s,
                             q.data[1] / s,
                             q.data[2] / s,
@@ -159,7 +154,7 @@ Type length(const Quaternion<Type>& q) {
 }
 
 template<typename Type>
-Type length_squared(const Quaternion<Type>& q) {
+constexpr Type length_squared(const Quaternion<Type>& q) {
     return q.data[0] * q.data[0] + q.data[1] * q.data[1] + q.data[2] * q.data[2] + q.data[3] * q.data[3];
 }
 
@@ -169,7 +164,7 @@ Quaternion<Type> quaternion_normal(const Quaternion<Type>& q) {
 }
 
 template<typename Type>
-Quaternion<Type> conjugate(const Quaternion<Type>& q) {
+constexpr Quaternion<Type> conjugate(const Quaternion<Type>& q) {
     return Quaternion<Type>{q.data[0],
                             -q.data[1],
                             -q.data[2],
@@ -182,10 +177,22 @@ Quaternion<Type> inverse(const Quaternion<Type>& q) {
 }
 
 template<typename Type>
-Type dot(const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
+constexpr Type dot(const Quaternion<Type>& q0, const Quaternion<Type>& q1) {
     return q0.data[0] * q1.data[0] + q0.data[1] * q1.data[1] + q0.data[2] * q1.data[2] + q0.data[3] * q1.data[3];
 }
 
+/*
+ * The rotation by angle around axis_normal, like Quaternion(axis_normal, angle),
+ * but usable in constant expressions.
+ */
+template<typename Type>
+constexpr Quaternion<Type> constant_rotation(const Vector<Type, 3>& axis_normal, const Type& angle) {
+    return Quaternion<Type>{static_cast<Type>(constant_cos(angle * 0.5)),
+                            static_cast<Type>(constant_sin(angle * 0.5)) * axis_normal[0],
+                            static_cast<Type>(constant_sin(angle * 0.5)) * axis_normal[1],
+                            static_cast<Type>(constant_sin(angle * 0.5)) * axis_normal[2]};
+}
+
 template<typename Type>
 Vector<Type, 3> rotate(const Quaternion<Type>& q, const Vector<Type, 3>& v) {
     Quaternion<Type> V{0, v[0], v[1], v[2]};
@@ -0,0 +1,306 @@
+//
+//  QuaternionBatch.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "QuaternionBatch.h"
+#include <algorithm>
+#include <cmath>
+#include "Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define QUATERNION_BATCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// The vector path only matches the scalar one if no multiply-add gets fused.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+static inline Quaternion<float> load(const QuaternionArrays& q, int i) {
+    return Quaternion<float>(q.w[i], q.x[i], q.y[i], q.z[i]);
+}
+
+static inline void store(const QuaternionArrays& q, int i, const Quaternion<float>& value) {
+    q.w[i] = value[0];
+    q.x[i] = value[1];
+    q.y[i] = value[2];
+    q.z[i] = value[3];
+}
+
+#ifdef QUATERNION_BATCH_SSE2
+
+struct Quaternion4 {
+    __m128 w, x, y, z;
+};
+
+static inline Quaternion4 load4(const QuaternionArrays& q, int i) {
+    Quaternion4 result = {_mm_loadu_ps(q.w + i), _mm_loadu_ps(q.x + i), _mm_loadu_ps(q.y + i), _mm_loadu_ps(q.z + i)};
+    return result;
+}
+
+static inline void store4(const QuaternionArrays& q, int i, const Quaternion4& value) {
+    _mm_storeu_ps(q.w + i, value.w);
+    _mm_storeu_ps(q.x + i, value.x);
+    _mm_storeu_ps(q.y + i, value.y);
+    _mm_storeu_ps(q.z + i, value.z);
+}
+
+// same association as dot(q0, q1) and length_squared(q)
+static inline __m128 dot4(const Quaternion4& q0, const Quaternion4& q1) {
+    __m128 d = _mm_add_ps(_mm_mul_ps(q0.w, q1.w), _mm_mul_ps(q0.x, q1.x));
+    d = _mm_add_ps(d, _mm_mul_ps(q0.y, q1.y));
+    return _mm_add_ps(d, _mm_mul_ps(q0.z, q1.z));
+}
+
+static inline Quaternion4 scale4(const Quaternion4& q, __m128 s) {
+    Quaternion4 result = {_mm_mul_ps(q.w, s), _mm_mul_ps(q.x, s), _mm_mul_ps(q.y, s), _mm_mul_ps(q.z, s)};
+    return result;
+}
+
+static inline Quaternion4 normal4(const Quaternion4& q) {
+    return scale4(q, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(dot4(q, q))));
+}
+
+// a * b - c * d + e * f + g * h, evaluated left to right like operator *
+static inline __m128 product_sum4(__m128 a, __m128 b, __m128 c, __m128 d, __m128 e, __m128 f, __m128 g, __m128 h) {
+    __m128 r = _mm_sub_ps(_mm_mul_ps(a, b), _mm_mul_ps(c, d));
+    r = _mm_add_ps(r, _mm_mul_ps(e, f));
+    return _mm_add_ps(r, _mm_mul_ps(g, h));
+}
+
+// one component of spherical_linear_interpolation, on the arc or linear
+static inline __m128 slerp_component4(__m128 p0, __m128 p1, __m128 t, __m128 w0, __m128 w1, __m128 sin_angle, __m128 arc) {
+    __m128 spherical = _mm_div_ps(_mm_add_ps(_mm_mul_ps(p0, w0), _mm_mul_ps(p1, w1)), sin_angle);
+    __m128 linear = _mm_add_ps(p0, _mm_mul_ps(_mm_sub_ps(p1, p0), t));
+    return _mm_or_ps(_mm_and_ps(arc, spherical), _mm_andnot_ps(arc, linear));
+}
+
+#endif
+
+void batch_quaternion_normal(const QuaternionArrays& q, const QuaternionArrays& out, int count) {
+    int i = 0;
+#ifdef QUATERNION_BATCH_SSE2
+    for (; i + 4 <= count; i += 4) {
+        store4(out, i, normal4(load4(q, i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        store(out, i, quaternion_normal(load(q, i)));
+    }
+}
+
+void batch_quaternion_multiply(const QuaternionArrays& q0, const QuaternionArrays& q1,
+                               const QuaternionArrays& out, int count) {
+    int i = 0;
+#ifdef QUATERNION_BATCH_SSE2
+    for (; i + 4 <= count; i += 4) {
+        Quaternion4 a = load4(q0, i);
+        Quaternion4 b = load4(q1, i);
+        Quaternion4 r;
+        r.w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(a.w, b.w), _mm_mul_ps(a.x, b.x)),
+                                    _mm_mul_ps(a.y, b.y)),
+                         _mm_mul_ps(a.z, b.z));
+        r.x = product_sum4(a.y, b.z, a.z, b.y, a.w, b.x, a.x, b.w);
+        r.y = product_sum4(a.z, b.x, a.x, b.z, a.w, b.y, a.y, b.w);
+        r.z = product_sum4(a.x, b.y, a.y, b.x, a.w, b.z, a.z, b.w);
+        store4(out, i, r);
+    }
+#endif
+    for (; i < count; ++i) {
+        store(out, i, load(q0, i) * load(q1, i));
+    }
+}
+
+void batch_rotate(const QuaternionArrays& q, const Vector3Arrays& v, const Vector3Arrays& out, int count) {
+    int i = 0;
+#ifdef QUATERNION_BATCH_SSE2
+    for (; i + 4 <= count; i += 4) {
+        Quaternion4 r = load4(q, i);
+        __m128 vx = _mm_loadu_ps(v.x + i);
+        __m128 vy = _mm_loadu_ps(v.y + i);
+        __m128 vz = _mm_loadu_ps(v.z + i);
+        __m128 two = _mm_set1_ps(2.0f);
+        __m128 tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(r.y, vz), _mm_mul_ps(r.z, vy)));
+        __m128 ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(r.z, vx), _mm_mul_ps(r.x, vz)));
+        __m128 tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(r.x, vy), _mm_mul_ps(r.y, vx)));
+        _mm_storeu_ps(out.x + i, _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(r.w, tx)),
+                                            _mm_sub_ps(_mm_mul_ps(r.y, tz), _mm_mul_ps(r.z, ty))));
+        _mm_storeu_ps(out.y + i, _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(r.w, ty)),
+                                            _mm_sub_ps(_mm_mul_ps(r.z, tx), _mm_mul_ps(r.x, tz))));
+        _mm_storeu_ps(out.z + i, _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(r.w, tz)),
+                                            _mm_sub_ps(_mm_mul_ps(r.x, ty), _mm_mul_ps(r.y, tx))));
+    }
+#endif
+    for (; i < count; ++i) {
+        float w = q.w[i], x = q.x[i], y = q.y[i], z = q.z[i];
+        float vx = v.x[i], vy = v.y[i], vz = v.z[i];
+        float tx = 2.0f * (y * vz - z * vy);
+        float ty = 2.0f * (z * vx - x * vz);
+        float tz = 2.0f * (x * vy - y * vx);
+        out.x[i] = (vx + w * tx) + (y * tz - z * ty);
+        out.y[i] = (vy + w * ty) + (z * tx - x * tz);
+        out.z[i] = (vz + w * tz) + (x * ty - y * tx);
+    }
+}
+
+void batch_quaternion_from_axis_angle(const Vector3Arrays& axis, const float* angle,
+                                      const QuaternionArrays& out, int count) {
+    const int chunk = 256;
+    float half[chunk];
+    float s[chunk];
+    for (int begin = 0; begin < count; begin += chunk) {
+        int n = std::min(chunk, count - begin);
+        for (int i = 0; i < n; ++i) {
+            half[i] = angle[begin + i] * 0.5f;
+        }
+        batch_sincos(half, s, out.w + begin, n);
+        for (int i = 0; i < n; ++i) {
+            out.x[begin + i] = s[i] * axis.x[begin + i];
+            out.y[begin + i] = s[i] * axis.y[begin + i];
+            out.z[begin + i] = s[i] * axis.z[begin + i];
+        }
+    }
+}
+
+void batch_nlerp(const QuaternionArrays& q0, const QuaternionArrays& q1, const float* t,
+                 const QuaternionArrays& out, int count) {
+    int i = 0;
+#ifdef QUATERNION_BATCH_SSE2
+    for (; i + 4 <= count; i += 4) {
+        Quaternion4 a = load4(q0, i);
+        Quaternion4 b = load4(q1, i);
+        __m128 vt = _mm_loadu_ps(t + i);
+        // flip q1 to the hemisphere of q0
+        __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot4(a, b), _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+        Quaternion4 r;
+        r.w = _mm_add_ps(a.w, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(b.w, flip), a.w), vt));
+        r.x = _mm_add_ps(a.x, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(b.x, flip), a.x), vt));
+        r.y = _mm_add_ps(a.y, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(b.y, flip), a.y), vt));
+        r.z = _mm_add_ps(a.z, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(b.z, flip), a.z), vt));
+        store4(out, i, normal4(r));
+    }
+#endif
+    for (; i < count; ++i) {
+        Quaternion<float> a = load(q0, i);
+        Quaternion<float> b = load(q1, i);
+        if (dot(a, b) < 0.0f) {
+            b = -1.0f * b;
+        }
+        store(out, i, quaternion_normal(linear_interpolation(a, b, t[i])));
+    }
+}
+
+// acos(d) for d in [0, 1], from the asin polynomial of Cephes' asinf:
+// asin(d) near 0, 2 * asin(sqrt((1 - d) / 2)) near 1
+static inline float slerp_acos(float d) {
+    bool big = d > 0.5f;
+    float x = big ? sqrtf((1.0f - d) * 0.5f) : d;
+    float z = x * x;
+    float p = 1.6666752422e-1f + z * (7.4953002686e-2f + z * (4.5470025998e-2f + z * (2.4181311049e-2f + z * 4.2163199048e-2f)));
+    float a = x + x * z * p;
+    return big ? 2.0f * a : 1.57079632679489662f - a;
+}
+
+#ifdef QUATERNION_BATCH_SSE2
+
+static inline __m128 slerp_acos4(__m128 d) {
+    __m128 big = _mm_cmpgt_ps(d, _mm_set1_ps(0.5f));
+    __m128 root = _mm_sqrt_ps(_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), d), _mm_set1_ps(0.5f)));
+    __m128 x = _mm_or_ps(_mm_and_ps(big, root), _mm_andnot_ps(big, d));
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 p = _mm_add_ps(_mm_set1_ps(2.4181311049e-2f), _mm_mul_ps(z, _mm_set1_ps(4.2163199048e-2f)));
+    p = _mm_add_ps(_mm_set1_ps(4.5470025998e-2f), _mm_mul_ps(z, p));
+    p = _mm_add_ps(_mm_set1_ps(7.4953002686e-2f), _mm_mul_ps(z, p));
+    p = _mm_add_ps(_mm_set1_ps(1.6666752422e-1f), _mm_mul_ps(z, p));
+    __m128 a = _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(x, z), p));
+    __m128 arc = _mm_mul_ps(_mm_set1_ps(2.0f), a);
+    __m128 complement = _mm_sub_ps(_mm_set1_ps(1.57079632679489662f), a);
+    return _mm_or_ps(_mm_and_ps(big, arc), _mm_andnot_ps(big, complement));
+}
+
+#endif
+
+void batch_slerp(const QuaternionArrays& q0, const QuaternionArrays& q1, const float* t,
+                 const QuaternionArrays& out, int count) {
+    const int chunk = 256;
+    // the angles of a chunk, angle * (1 - t), angle * t and angle one after
+    // another, so that one batch_sincos call takes all their sines
+    float phase[3 * chunk];
+    float sine[3 * chunk];
+    for (int begin = 0; begin < count; begin += chunk) {
+        int n = std::min(chunk, count - begin);
+        int i = 0;
+#ifdef QUATERNION_BATCH_SSE2
+        for (; i + 4 <= n; i += 4) {
+            __m128 d = _mm_andnot_ps(_mm_set1_ps(-0.0f), dot4(load4(q0, begin + i), load4(q1, begin + i)));
+            __m128 angle = slerp_acos4(d);
+            __m128 vt = _mm_loadu_ps(t + begin + i);
+            _mm_storeu_ps(phase + i, _mm_mul_ps(angle, _mm_sub_ps(_mm_set1_ps(1.0f), vt)));
+            _mm_storeu_ps(phase + n + i, _mm_mul_ps(angle, vt));
+            _mm_storeu_ps(phase + 2 * n + i, angle);
+        }
+#endif
+        for (; i < n; ++i) {
+            float angle = slerp_acos(fabsf(dot(load(q0, begin + i), load(q1, begin + i))));
+            phase[i] = angle * (1.0f - t[begin + i]);
+            phase[n + i] = angle * t[begin + i];
+            phase[2 * n + i] = angle;
+        }
+
+        // lanes that interpolate linearly get sines that are never used
+        batch_sincos(phase, sine, 0, 3 * n);
+
+        i = 0;
+#ifdef QUATERNION_BATCH_SSE2
+        for (; i + 4 <= n; i += 4) {
+            Quaternion4 a = load4(q0, begin + i);
+            Quaternion4 b = load4(q1, begin + i);
+            __m128 vt = _mm_loadu_ps(t + begin + i);
+            __m128 d = dot4(a, b);
+            __m128 flip = _mm_and_ps(_mm_cmplt_ps(d, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+            d = _mm_xor_ps(d, flip);
+            b.w = _mm_xor_ps(b.w, flip);
+            b.x = _mm_xor_ps(b.x, flip);
+            b.y = _mm_xor_ps(b.y, flip);
+            b.z = _mm_xor_ps(b.z, flip);
+            // d < 0.95 in double, as in spherical_linear_interpolation
+            __m128 arc = _mm_cmple_ps(d, _mm_set1_ps(0.95f));
+            __m128 w0 = _mm_loadu_ps(sine + i);
+            __m128 w1 = _mm_loadu_ps(sine + n + i);
+            __m128 sin_angle = _mm_loadu_ps(sine + 2 * n + i);
+
+            Quaternion4 r;
+            r.w = slerp_component4(a.w, b.w, vt, w0, w1, sin_angle, arc);
+            r.x = slerp_component4(a.x, b.x, vt, w0, w1, sin_angle, arc);
+            r.y = slerp_component4(a.y, b.y, vt, w0, w1, sin_angle, arc);
+            r.z = slerp_component4(a.z, b.z, vt, w0, w1, sin_angle, arc);
+            store4(out, begin + i, r);
+        }
+#endif
+        for (; i < n; ++i) {
+            Quaternion<float> a = load(q0, begin + i);
+            Quaternion<float> b = load(q1, begin + i);
+            float vt = t[begin + i];
+            float d = dot(a, b);
+            if (d < 0.0f) {
+                d = -d;
+                b = -1.0f * b;
+            }
+            Quaternion<float> r;
+            for (int k = 0; k < 4; ++k) {
+                if (d <= 0.95f) {
+                    r[k] = (a[k] * sine[i] + b[k] * sine[n + i]) / sine[2 * n + i];
+                } else {
+                    r[k] = a[k] + (b[k] - a[k]) * vt;
+                }
+            }
+            store(out, begin + i, r);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+//
+//  QuaternionBatch.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __game__QuaternionBatch__
+#define __game__QuaternionBatch__
+
+/*
+ * Quaternion operations on structure of arrays storage, four quaternions per
+ * instruction. Element i of a QuaternionArrays is the quaternion
+ * (w[i], x[i], y[i], z[i]) with w the real part, as in Quaternion<float>.
+ * Every function also handles counts that are no multiple of four, and the
+ * vector and scalar paths give bit identical results.
+ *
+ * Outputs may alias inputs element for element (out.w == in.w etc.), but the
+ * arrays of one argument must not overlap.
+ */
+struct QuaternionArrays {
+    float* w;
+    float* x;
+    float* y;
+    float* z;
+};
+
+struct Vector3Arrays {
+    float* x;
+    float* y;
+    float* z;
+};
+
+// out[i] = quaternion_normal(q[i])
+void batch_quaternion_normal(const QuaternionArrays& q, const QuaternionArrays& out, int count);
+
+// out[i] = q0[i] * q1[i]
+void batch_quaternion_multiply(const QuaternionArrays& q0, const QuaternionArrays& q1,
+                               const QuaternionArrays& out, int count);
+
+/*
+ * out[i] = rotate(q[i], v[i]) for unit quaternions, computed as
+ * v + w * t + u x t with u = (x, y, z) and t = 2 * u x v. Equal to rotate()
+ * up to rounding.
+ */
+void batch_rotate(const QuaternionArrays& q, const Vector3Arrays& v, const Vector3Arrays& out, int count);
+
+/*
+ * The unit quaternions rotating by angle[i] around the unit axis[i], like
+ * Quaternion(axis, angle). The half angles go through batch_sincos, so the
+ * components have an absolute error of about 1e-7 for |angle| <= 16384.
+ */
+void batch_quaternion_from_axis_angle(const Vector3Arrays& axis, const float* angle,
+                                      const QuaternionArrays& out, int count);
+
+// out[i] = quaternion_normal(linear_interpolation(q0[i], +-q1[i], t[i])), along the shorter arc
+void batch_nlerp(const QuaternionArrays& q0, const QuaternionArrays& q1, const float* t,
+                 const QuaternionArrays& out, int count);
+
+/*
+ * out[i] = spherical_linear_interpolation(q0[i], q1[i], t[i]), with the arc
+ * angle from a polynomial acos and its sines from batch_sincos, so the arc
+ * weights are computed four at a time as well. The components differ from
+ * spherical_linear_interpolation by about 2.5e-7 at most, for t in [0, 1].
+ */
+void batch_slerp(const QuaternionArrays& q0, const QuaternionArrays& q1, const float* t,
+                 const QuaternionArrays& out, int count);
+
+#endif /* defined(__game__QuaternionBatch__) */
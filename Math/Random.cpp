@@ -0,0 +1,119 @@
+//
+//  Random.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "Random.h"
+
+#include <atomic>
+
+static const uint32_t philox_m0 = 0xD2511F53;
+static const uint32_t philox_m1 = 0xCD9E8D57;
+static const uint32_t philox_w0 = 0x9E3779B9;
+static const uint32_t philox_w1 = 0xBB67AE85;
+static const uint64_t no_block = ~(uint64_t)0;
+
+static inline void philox_round(uint32_t* c, const uint32_t* k) {
+    uint64_t p0 = (uint64_t)philox_m0 * c[0];
+    uint64_t p1 = (uint64_t)philox_m1 * c[2];
+    uint32_t c0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k[0];
+    uint32_t c2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k[1];
+    c[1] = (uint32_t)p1;
+    c[3] = (uint32_t)p0;
+    c[0] = c0;
+    c[2] = c2;
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream)
+: _position(0), _block_index(no_block) {
+    _key[0] = (uint32_t)seed;
+    _key[1] = (uint32_t)(seed >> 32);
+    _stream[0] = (uint32_t)stream;
+    _stream[1] = (uint32_t)(stream >> 32);
+}
+
+void RandomStream::load_block(uint64_t index) {
+    uint32_t k[2] = {_key[0], _key[1]};
+    _block[0] = (uint32_t)index;
+    _block[1] = (uint32_t)(index >> 32);
+    _block[2] = _stream[0];
+    _block[3] = _stream[1];
+    for (int round = 0; round < 9; ++round) {
+        philox_round(_block, k);
+        k[0] += philox_w0;
+        k[1] += philox_w1;
+    }
+    philox_round(_block, k);
+    _block_index = index;
+}
+
+uint32_t RandomStream::operator () () {
+    uint64_t index = _position >> 2;
+    if (index != _block_index) {
+        load_block(index);
+    }
+    return _block[_position++ & 3];
+}
+
+float RandomStream::uniform() {
+    // the upper 24 bits, every value is exact in a float
+    return (float)((*this)() >> 8) * (1.0f / 16777216.0f);
+}
+
+float RandomStream::uniform(float from, float to) {
+    return from + (to - from) * uniform();
+}
+
+int RandomStream::range(int from, int to) {
+    // floor(u * span / 2^64) for a 64 bit u, the bias is at most span / 2^64
+    uint64_t span = (uint64_t)((int64_t)to - (int64_t)from) + 1;
+    uint64_t lo = (*this)();
+    uint64_t hi = (*this)();
+    uint64_t offset = (hi * span + ((lo * span) >> 32)) >> 32;
+    return (int)((int64_t)from + (int64_t)offset);
+}
+
+void RandomStream::fill(float* out, int count, float from, float to) {
+    for (int i = 0; i < count; ++i) {
+        out[i] = uniform(from, to);
+    }
+}
+
+void RandomStream::fill(int* out, int count, int from, int to) {
+    for (int i = 0; i < count; ++i) {
+        out[i] = range(from, to);
+    }
+}
+
+void RandomStream::discard(uint64_t n) {
+    _position += n;
+}
+
+uint64_t RandomStream::position() const {
+    return _position;
+}
+
+// random_seed starts a new generation, threads pick up the new seed the next
+// time they ask for their stream
+static std::atomic<uint64_t> global_seed(0);
+static std::atomic<unsigned int> global_generation(0);
+static std::atomic<uint64_t> next_thread_stream(0);
+
+void reseed_thread_random_streams(uint64_t seed) {
+    global_seed.store(seed);
+    next_thread_stream.store(0);
+    global_generation.fetch_add(1);
+}
+
+RandomStream& thread_random_stream() {
+    static thread_local RandomStream stream;
+    static thread_local unsigned int generation = ~0u;
+    unsigned int current = global_generation.load();
+    if (generation != current) {
+        generation = current;
+        stream = RandomStream(global_seed.load(), next_thread_stream.fetch_add(1));
+    }
+    return stream;
+}
@@ -0,0 +1,70 @@
+//
+//  Random.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __game__Random__
+#define __game__Random__
+
+#include <stdint.h>
+
+/*
+ * Counter based random numbers (Philox4x32-10).
+ *
+ * The n´th output of a stream is a pure function of (seed, stream, n), so a
+ * stream can jump to any position in constant time and there is no shared
+ * state. Work that is split across threads stays reproducible as long as
+ * every item takes its numbers from a fixed (stream, position), e.g. one
+ * stream per map chunk or AI rollout, or one stream whose range is divided
+ * with discard(). The results do not depend on the number of threads.
+ */
+class RandomStream {
+    uint32_t _key[2];
+    uint32_t _stream[2];
+    uint64_t _position;
+
+    // the block that holds the outputs _block_index * 4 to _block_index * 4 + 3
+    uint64_t _block_index;
+    uint32_t _block[4];
+
+    void load_block(uint64_t index);
+
+public:
+    typedef uint32_t result_type;
+
+    explicit RandomStream(uint64_t seed = 0, uint64_t stream = 0);
+
+    // 32 random bits, also makes this usable with the <random> distributions
+    uint32_t operator () ();
+    static constexpr uint32_t min() { return 0; }
+    static constexpr uint32_t max() { return 0xFFFFFFFF; }
+
+    // uniform in [0, 1)
+    float uniform();
+    // uniform in [from, to)
+    float uniform(float from, float to);
+    // uniform in [from, to], without the modulo bias of rand() % n
+    int range(int from, int to);
+
+    // fill out with count numbers, the same as count calls of uniform/range
+    void fill(float* out, int count, float from, float to);
+    void fill(int* out, int count, int from, int to);
+
+    // skip n outputs of operator (); uniform takes one output, range two
+    void discard(uint64_t n);
+    uint64_t position() const;
+};
+
+/*
+ * The calling thread's stream. Every thread starts with its own stream of the
+ * last seed given to reseed_thread_random_streams (or random_seed), numbered
+ * in the order the threads first use it after reseeding. The numbering depends
+ * on scheduling, so parallel work that must be reproducible should construct
+ * its RandomStreams explicitly.
+ */
+RandomStream& thread_random_stream();
+void reseed_thread_random_streams(uint64_t seed);
+
+#endif /* defined(__game__Random__) */
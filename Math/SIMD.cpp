@@ -0,0 +1,8 @@
+//
+//  SIMD.cpp
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#include "SIMD.h"
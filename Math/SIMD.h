@@ -0,0 +1,255 @@
+//
+//  SIMD.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __game__SIMD__
+#define __game__SIMD__
+
+#include "Vector4.h"
+#include "Matrix4.h"
+
+/*
+ * SSE kernels for the float 4-vector and 4x4 matrix operations. They are
+ * plain (non-template) overloads, so overload resolution prefers them over
+ * the generic templates whenever both operands are float.
+ *
+ * Every kernel performs the same floating point operations in the same order
+ * as its scalar fallback, so both paths produce bit identical results;
+ * Benchmarks/SIMDCheck.cpp compares them. Define MATH_NO_SIMD to force the
+ * scalar fallback.
+ */
+#if !defined(MATH_NO_SIMD) && (defined(__SSE__) || defined(_M_X64))
+#define MATH_SIMD_SSE 1
+#include <xmmintrin.h>
+#if defined(__AVX__)
+#define MATH_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+#endif
+
+inline Vector<float, 4> operator + (const Vector<float, 4>& a, const Vector<float, 4>& b) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_add_ps(_mm_loadu_ps(a.data), _mm_loadu_ps(b.data)));
+#else
+    result[0] = a[0] + b[0];
+    result[1] = a[1] + b[1];
+    result[2] = a[2] + b[2];
+    result[3] = a[3] + b[3];
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator + (const Vector<float, 4>& a, const float& s) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_add_ps(_mm_loadu_ps(a.data), _mm_set1_ps(s)));
+#else
+    result[0] = a[0] + s;
+    result[1] = a[1] + s;
+    result[2] = a[2] + s;
+    result[3] = a[3] + s;
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator + (const float& s, const Vector<float, 4>& a) {
+    return a + s;
+}
+
+inline Vector<float, 4> operator - (const Vector<float, 4>& a, const Vector<float, 4>& b) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_sub_ps(_mm_loadu_ps(a.data), _mm_loadu_ps(b.data)));
+#else
+    result[0] = a[0] - b[0];
+    result[1] = a[1] - b[1];
+    result[2] = a[2] - b[2];
+    result[3] = a[3] - b[3];
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator - (const Vector<float, 4>& a, const float& s) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_sub_ps(_mm_loadu_ps(a.data), _mm_set1_ps(s)));
+#else
+    result[0] = a[0] - s;
+    result[1] = a[1] - s;
+    result[2] = a[2] - s;
+    result[3] = a[3] - s;
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator - (const Vector<float, 4>& a) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    // flip the sign bit, exactly what scalar negation does
+    _mm_storeu_ps(result.data, _mm_xor_ps(_mm_loadu_ps(a.data), _mm_set1_ps(-0.0f)));
+#else
+    result[0] = -a[0];
+    result[1] = -a[1];
+    result[2] = -a[2];
+    result[3] = -a[3];
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator * (const Vector<float, 4>& a, const Vector<float, 4>& b) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_mul_ps(_mm_loadu_ps(a.data), _mm_loadu_ps(b.data)));
+#else
+    result[0] = a[0] * b[0];
+    result[1] = a[1] * b[1];
+    result[2] = a[2] * b[2];
+    result[3] = a[3] * b[3];
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator * (const Vector<float, 4>& a, const float& s) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_mul_ps(_mm_loadu_ps(a.data), _mm_set1_ps(s)));
+#else
+    result[0] = a[0] * s;
+    result[1] = a[1] * s;
+    result[2] = a[2] * s;
+    result[3] = a[3] * s;
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator * (const float& s, const Vector<float, 4>& a) {
+    return a * s;
+}
+
+inline Vector<float, 4> operator / (const Vector<float, 4>& a, const Vector<float, 4>& b) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_div_ps(_mm_loadu_ps(a.data), _mm_loadu_ps(b.data)));
+#else
+    result[0] = a[0] / b[0];
+    result[1] = a[1] / b[1];
+    result[2] = a[2] / b[2];
+    result[3] = a[3] / b[3];
+#endif
+    return result;
+}
+
+inline Vector<float, 4> operator / (const Vector<float, 4>& a, const float& s) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    _mm_storeu_ps(result.data, _mm_div_ps(_mm_loadu_ps(a.data), _mm_set1_ps(s)));
+#else
+    result[0] = a[0] / s;
+    result[1] = a[1] / s;
+    result[2] = a[2] / s;
+    result[3] = a[3] / s;
+#endif
+    return result;
+}
+
+inline float dot(const Vector<float, 4>& a, const Vector<float, 4>& b) {
+#ifdef MATH_SIMD_SSE
+    // sum the products from left to right like the scalar version does
+    __m128 p = _mm_mul_ps(_mm_loadu_ps(a.data), _mm_loadu_ps(b.data));
+    __m128 r = _mm_add_ss(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)));
+    r = _mm_add_ss(r, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)));
+    r = _mm_add_ss(r, _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3)));
+    return _mm_cvtss_f32(r);
+#else
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+#endif
+}
+
+/*
+ * Matrix vector product. The matrix is stored column major, so the result is
+ * the sum of the columns weighted by the vector components.
+ */
+inline Vector<float, 4> operator * (const Matrix<float, 4, 4>& a, const Vector<float, 4>& b) {
+    Vector<float, 4> result;
+#ifdef MATH_SIMD_SSE
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(a.data + 0), _mm_set1_ps(b[0]));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a.data + 4), _mm_set1_ps(b[1])));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a.data + 8), _mm_set1_ps(b[2])));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a.data + 12), _mm_set1_ps(b[3])));
+    _mm_storeu_ps(result.data, r);
+#else
+    for (int i = 0; i < 4; ++i) {
+        result[i] = a(i,0) * b[0] + a(i,1) * b[1] + a(i,2) * b[2] + a(i,3) * b[3];
+    }
+#endif
+    return result;
+}
+
+/*
+ * Matrix product. Column i of the result is a * (column i of b).
+ */
+inline Matrix<float, 4, 4> operator * (const Matrix<float, 4, 4>& a, const Matrix<float, 4, 4>& b) {
+    Matrix<float, 4, 4> result;
+#if defined(MATH_SIMD_AVX)
+    // two result columns per iteration, one in each 128 bit lane
+    __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.data + 0));
+    __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.data + 4));
+    __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.data + 8));
+    __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.data + 12));
+    for (int i = 0; i < 16; i += 8) {
+        __m256 b01 = _mm256_loadu_ps(b.data + i);
+        __m256 r = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_permute_ps(b01, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_permute_ps(b01, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_permute_ps(b01, 0xFF)));
+        _mm256_storeu_ps(result.data + i, r);
+    }
+#elif defined(MATH_SIMD_SSE)
+    __m128 a0 = _mm_loadu_ps(a.data + 0);
+    __m128 a1 = _mm_loadu_ps(a.data + 4);
+    __m128 a2 = _mm_loadu_ps(a.data + 8);
+    __m128 a3 = _mm_loadu_ps(a.data + 12);
+    for (int i = 0; i < 16; i += 4) {
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(b.data[i + 0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b.data[i + 1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b.data[i + 2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b.data[i + 3])));
+        _mm_storeu_ps(result.data + i, r);
+    }
+#else
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result(j,i) = a(j,0) * b(0,i) + a(j,1) * b(1,i) + a(j,2) * b(2,i) + a(j,3) * b(3,i);
+        }
+    }
+#endif
+    return result;
+}
+
+inline Matrix<float, 4, 4> transpose(const Matrix<float, 4, 4>& a) {
+    Matrix<float, 4, 4> result;
+#ifdef MATH_SIMD_SSE
+    __m128 c0 = _mm_loadu_ps(a.data + 0);
+    __m128 c1 = _mm_loadu_ps(a.data + 4);
+    __m128 c2 = _mm_loadu_ps(a.data + 8);
+    __m128 c3 = _mm_loadu_ps(a.data + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(result.data + 0, c0);
+    _mm_storeu_ps(result.data + 4, c1);
+    _mm_storeu_ps(result.data + 8, c2);
+    _mm_storeu_ps(result.data + 12, c3);
+#else
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result(i,j) = a(j,i);
+        }
+    }
+#endif
+    return result;
+}
+
+#endif /* defined(__game__SIMD__) */
@@ -14,6 +14,7 @@
 void Transformation3::set_dirty() {
     _dirty_local_to_world = true;
     _dirty_world_to_local = true;
+    _dirty_normal = true;
     _dirty_world_x = true;
     _dirty_world_y = true;
     _dirty_world_z = true;
@@ -22,6 +23,7 @@ void Transformation3::set_dirty() {
 void Transformation3::set_rotation_dirty() {
     _dirty_local_to_world = true;
     _dirty_world_to_local = true;
+    _dirty_normal = true;
     _dirty_world_x = true;
     _dirty_world_y = true;
     _dirty_world_z = true;
@@ -45,15 +47,21 @@ void Transformation3::update_local_to_world() {
 
 void Transformation3::update_world_to_local() {
     if (_dirty_world_to_local) {
-        _world_to_local = ::homogeneous_rotation(inverse(_rotation));
-        _world_to_local(0,3) = -(_world_to_local(0,0) * _translation[0] + _world_to_local(0,1) * _translation[1] + _world_to_local(0,2) * _translation[2]);
-        _world_to_local(1,3) = -(_world_to_local(1,0) * _translation[0] + _world_to_local(1,1) * _translation[1] + _world_to_local(1,2) * _translation[2]);
-        _world_to_local(2,3) = -(_world_to_local(2,0) * _translation[0] + _world_to_local(2,1) * _translation[1] + _world_to_local(2,2) * _translation[2]);
+        // transposes the cached rotation instead of building a second one
+        _world_to_local = rigid_inverse(local_to_world());
         //_world_to_local = ::homogeneous_rotation(inverse(_rotation)) * ::homogeneous_translation(-_translation);
     }
     _dirty_world_to_local = false;
 }
 
+void Transformation3::update_normal() {
+    if (_dirty_normal) {
+        _local_to_world_normal = ::rotation(_rotation);
+        _world_to_local_normal = transpose(_local_to_world_normal);
+    }
+    _dirty_normal = false;
+}
+
 void Transformation3::update_world_x() {
     if (_dirty_world_x) {
         _world_x = rotate(_rotation, Vector<float, 3>(1.0f, 0.0f, 0.0f));
@@ -76,35 +84,35 @@ void Transformation3::update_world_z() {
 }
 
 Transformation3::Transformation3()
-: _dirty_local_to_world(false), _dirty_world_to_local(false),
+: _dirty_local_to_world(false), _dirty_world_to_local(false), _dirty_normal(false),
 _dirty_world_x(true), _dirty_world_y(true), _dirty_world_z(true) {
     
 }
 
 Transformation3::Transformation3(const Quaternion<float>& rotation)
 : _rotation(rotation),
-_dirty_local_to_world(true), _dirty_world_to_local(true),
+_dirty_local_to_world(true), _dirty_world_to_local(true), _dirty_normal(true),
 _dirty_world_x(true), _dirty_world_y(true), _dirty_world_z(true) {
     
 }
 
 Transformation3::Transformation3(const Vector<float, 3>& translation)
 : _translation(translation),
-_dirty_local_to_world(true), _dirty_world_to_local(true),
+_dirty_local_to_world(true), _dirty_world_to_local(true), _dirty_normal(true),
 _dirty_world_x(true), _dirty_world_y(true), _dirty_world_z(true) {
     
 }
 
 Transformation3::Transformation3(const Quaternion<float>& rotation, const Vector<float, 3>& translation)
 : _rotation(rotation), _translation(translation),
-_dirty_local_to_world(true), _dirty_world_to_local(true),
+_dirty_local_to_world(true), _dirty_world_to_local(true), _dirty_normal(true),
 _dirty_world_x(true), _dirty_world_y(true), _dirty_world_z(true) {
     
 }
 
 Transformation3::Transformation3(const Vector<float, 3>& eye, const Vector<float, 3>& look_at, const Vector<float, 3>& up)
 : _rotation(eye, look_at, up), _translation(eye),
-_dirty_local_to_world(true), _dirty_world_to_local(true),
+_dirty_local_to_world(true), _dirty_world_to_local(true), _dirty_normal(true),
 _dirty_world_x(true), _dirty_world_y(true), _dirty_world_z(true){
     
 }
@@ -166,6 +174,17 @@ const Matrix<float, 4, 4>& Transformation3::world_to_local() {
     return _world_to_local;
 }
 
+// returns the cached normal matrices and updates them if needed
+const Matrix<float, 3, 3>& Transformation3::local_to_world_normal() {
+    update_normal();
+    return _local_to_world_normal;
+}
+
+const Matrix<float, 3, 3>& Transformation3::world_to_local_normal() {
+    update_normal();
+    return _world_to_local_normal;
+}
+
 // returns the cached axis vectors and updates if needed
 const Vector<float, 3>& Transformation3::world_x() {
     update_world_x();
@@ -23,6 +23,9 @@ class Transformation3 {
     Matrix<float, 4, 4> _local_to_world;
     bool _dirty_world_to_local;
     Matrix<float, 4, 4> _world_to_local;
+    bool _dirty_normal;
+    Matrix<float, 3, 3> _local_to_world_normal;
+    Matrix<float, 3, 3> _world_to_local_normal;
     
     // cached axis vectors
     bool _dirty_world_x;
@@ -38,6 +41,7 @@ class Transformation3 {
     void set_translation_dirty();
     void update_local_to_world();
     void update_world_to_local();
+    void update_normal();
     void update_world_x();
     void update_world_y();
     void update_world_z();
@@ -80,6 +84,12 @@ public:
     const Matrix<float, 4, 4>& local_to_world();
     const Matrix<float, 4, 4>& world_to_local();
     
+    // returns the cached normal matrices (the inverse transposes of the
+    // matrices above) and updates them if needed. There is no scale, so these
+    // are the pure rotations.
+    const Matrix<float, 3, 3>& local_to_world_normal();
+    const Matrix<float, 3, 3>& world_to_local_normal();
+    
     // returns the cached axis vectors and updates if needed
     const Vector<float, 3>& world_x();
     const Vector<float, 3>& world_y();
@@ -24,7 +24,7 @@ struct Vector {
     /*
      * Create a vector an initialize each element with 0.
      */
-    Vector() : Vector{0} {}
+    constexpr Vector() : data{} {}
     
     /*
      * Create a vector an initialize each element with t.
@@ -24,25 +24,22 @@ struct Vector<Type,2> {
     /*
      * Create a vector an initialize each element with 0.
      */
-    Vector() : Vector{0, 0} {}
+    constexpr Vector() : Vector{0, 0} {}
     
     /*
      * Create a vector an initialize each element with t.
      */
-    explicit Vector(const Type& t) : Vector{t, t} {}
+    constexpr explicit Vector(const Type& t) : Vector{t, t} {}
     
     /*
      * Create a vector from the provided values
      */
-    Vector(const Type& x, const Type& y) {
-        data[0] = x;
-        data[1] = y;
-    }
+    constexpr Vector(const Type& x, const Type& y) : data{x, y} {}
     
     /*
      * Access the i´th element in the vector.
      */
-    const Type& operator[] (int i) const {
+    constexpr const Type& operator[] (int i) const {
         return data[i];
     }
     
@@ -127,73 +124,73 @@ struct Vector<Type,2> {
 }; // Vector
 
 template<typename Type>
-inline Vector<Type, 2> operator + (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
+constexpr Vector<Type, 2> operator + (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
     return Vector<Type, 2>{a[0] + b[0],
                            a[1] + b[1]};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator + (const Vector<Type, 2>& a, const Type& s) {
+constexpr Vector<Type, 2> operator + (const Vector<Type, 2>& a, const Type& s) {
     return Vector<Type, 2>{a[0] + s,
                            a[1] + s};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator + (const Type& s, const Vector<Type, 2>& a) {
+constexpr Vector<Type, 2> operator + (const Type& s, const Vector<Type, 2>& a) {
     return Vector<Type, 2>{a[0] + s,
                            a[1] + s};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator - (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
+constexpr Vector<Type, 2> operator - (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
     return Vector<Type, 2>{a[0] - b[0],
                            a[1] - b[1]};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator - (const Vector<Type, 2>& a, const Type& s) {
+constexpr Vector<Type, 2> operator - (const Vector<Type, 2>& a, const Type& s) {
     return Vector<Type, 2>{a[0] - s,
                            a[1] - s};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator - (const Vector<Type, 2>& a) {
+constexpr Vector<Type, 2> operator - (const Vector<Type, 2>& a) {
     return Vector<Type, 2>{-a[0],
                            -a[1]};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator * (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
+constexpr Vector<Type, 2> operator * (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
     return Vector<Type, 2>{a[0] * b[0],
                            a[1] * b[1]};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator * (const Vector<Type, 2>& a, const Type& s) {
+constexpr Vector<Type, 2> operator * (const Vector<Type, 2>& a, const Type& s) {
     return Vector<Type, 2>{a[0] * s,
                            a[1] * s};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator * (const Type& s, const Vector<Type, 2>& a) {
+constexpr Vector<Type, 2> operator * (const Type& s, const Vector<Type, 2>& a) {
     return Vector<Type, 2>{a[0] * s,
                            a[1] * s};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator / (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
+constexpr Vector<Type, 2> operator / (const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
     return Vector<Type, 2>{a[0] / b[0],
                            a[1] / b[1]};
 }
 
 template<typename Type>
-inline Vector<Type, 2> operator / (const Vector<Type, 2>& a, const Type& s) {
+constexpr Vector<Type, 2> operator / (const Vector<Type, 2>& a, const Type& s) {
     return Vector<Type, 2>{a[0] / s,
                            a[1] / s};
 }
 
 template<typename Type>
-Type dot(const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
+constexpr Type dot(const Vector<Type, 2>& a, const Vector<Type, 2>& b) {
     return a[0] * b[0] + a[1] * b[1];
 }
 
@@ -24,26 +24,22 @@ struct Vector<Type,3> {
     /*
      * Create a vector an initialize each element with 0.
      */
-    Vector() : Vector{0, 0, 0} {}
+    constexpr Vector() : Vector{0, 0, 0} {}
     
     /*
      * Create a vector an initialize each element with t.
      */
-    explicit Vector(const Type& t) : Vector{t, t, t} {}
+    constexpr explicit Vector(const Type& t) : Vector{t, t, t} {}
     
     /*
      * Create a vector from the provided values
      */
-    Vector(const Type& x, const Type& y, const Type& z) {
-        data[0] = x;
-        data[1] = y;
-        data[2] = z;
-    }
+    constexpr Vector(const Type& x, const Type& y, const Type& z) : data{x, y, z} {}
     
     /*
      * Access the i´th element in the vector.
      */
-    const Type& operator[] (int i) const {
+    constexpr const Type& operator[] (int i) const {
         return data[i];
     }
     
@@ -136,89 +132,89 @@ struct Vector<Type,3> {
 }; // Vector
 
 template<typename Type>
-inline Vector<Type, 3> operator + (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
+constexpr Vector<Type, 3> operator + (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
     return Vector<Type, 3>{a[0] + b[0],
                            a[1] + b[1],
                            a[2] + b[2]};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator + (const Vector<Type, 3>& a, const Type& s) {
+constexpr Vector<Type, 3> operator + (const Vector<Type, 3>& a, const Type& s) {
     return Vector<Type, 3>{a[0] + s,
                            a[1] + s,
                            a[2] + s};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator + (const Type& s, const Vector<Type, 3>& a) {
+constexpr Vector<Type, 3> operator + (const Type& s, const Vector<Type, 3>& a) {
     return Vector<Type, 3>{a[0] + s,
                            a[1] + s,
                            a[2] + s};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator - (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
+constexpr Vector<Type, 3> operator - (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
     return Vector<Type, 3>{a[0] - b[0],
                            a[1] - b[1],
                            a[2] - b[2]};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator - (const Vector<Type, 3>& a, const Type& s) {
+constexpr Vector<Type, 3> operator - (const Vector<Type, 3>& a, const Type& s) {
     return Vector<Type, 3>{a[0] - s,
                            a[1] - s,
                            a[2] - s};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator - (const Vector<Type, 3>& a) {
+constexpr Vector<Type, 3> operator - (const Vector<Type, 3>& a) {
     return Vector<Type, 3>{-a[0],
                            -a[1],
                            -a[2]};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator * (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
+constexpr Vector<Type, 3> operator * (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
     return Vector<Type, 3>{a[0] * b[0],
                            a[1] * b[1],
                            a[2] * b[2]};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator * (const Vector<Type, 3>& a, const Type& s) {
+constexpr Vector<Type, 3> operator * (const Vector<Type, 3>& a, const Type& s) {
     return Vector<Type, 3>{a[0] * s,
                            a[1] * s,
                            a[2] * s};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator * (const Type& s, const Vector<Type, 3>& a) {
+constexpr Vector<Type, 3> operator * (const Type& s, const Vector<Type, 3>& a) {
     return Vector<Type, 3>{a[0] * s,
                            a[1] * s,
                            a[2] * s};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator / (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
+constexpr Vector<Type, 3> operator / (const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
     return Vector<Type, 3>{a[0] / b[0],
                            a[1] / b[1],
                            a[2] / b[2]};
 }
 
 template<typename Type>
-inline Vector<Type, 3> operator / (const Vector<Type, 3>& a, const Type& s) {
+constexpr Vector<Type, 3> operator / (const Vector<Type, 3>& a, const Type& s) {
     return Vector<Type, 3>{a[0] / s,
                            a[1] / s,
                            a[2] / s};
 }
 
 template<typename Type>
-Type dot(const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
+constexpr Type dot(const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
     return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
 }
 
 template<typename Type>
-Vector<Type, 3> cross(const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
+constexpr Vector<Type, 3> cross(const Vector<Type, 3>& a, const Vector<Type, 3>& b) {
     return Vector<Type, 3>{a[1] * b[2] - a[2] * b[1],
                            a[2] * b[0] - a[0] * b[2],
                            a[0] * b[1] - a[1] * b[0]};
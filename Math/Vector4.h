@@ -24,27 +24,22 @@ struct Vector<Type,4> {
     /*
      * Create a vector an initialize each element with 0.
      */
-    Vector() : Vector{0, 0, 0, 0} {}
+    constexpr Vector() : Vector{0, 0, 0, 0} {}
     
     /*
      * Create a vector an initialize each element with t.
      */
-    explicit Vector(const Type& t) : Vector{t, t, t, t} {}
+    constexpr explicit Vector(const Type& t) : Vector{t, t, t, t} {}
     
     /*
      * Create a vector from the provided values
      */
-    Vector(const Type& x, const Type& y, const Type& z, const Type& w) {
-        data[0] = x;
-        data[1] = y;
-        data[2] = z;
-        data[3] = w;
-    }
+    constexpr Vector(const Type& x, const Type& y, const Type& z, const Type& w) : data{x, y, z, w} {}
     
     /*
      * Access the i´th element in the vector.
      */
-    const Type& operator[] (int i) const {
+    constexpr const Type& operator[] (int i) const {
         return data[i];
     }
     
@@ -145,7 +140,7 @@ struct Vector<Type,4> {
 }; // Vector
 
 template<typename Type>
-inline Vector<Type, 4> operator + (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
+constexpr Vector<Type, 4> operator + (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
     return Vector<Type, 4>{a[0] + b[0],
                            a[1] + b[1],
                            a[2] + b[2],
@@ -153,7 +148,7 @@ inline Vector<Type, 4> operator + (const Vector<Type, 4>& a, const Vector<Type,
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator + (const Vector<Type, 4>& a, const Type& s) {
+constexpr Vector<Type, 4> operator + (const Vector<Type, 4>& a, const Type& s) {
     return Vector<Type, 4>{a[0] + s,
                            a[1] + s,
                            a[2] + s,
@@ -161,7 +156,7 @@ inline Vector<Type, 4> operator + (const Vector<Type, 4>& a, const Type& s) {
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator + (const Type& s, const Vector<Type, 4>& a) {
+constexpr Vector<Type, 4> operator + (const Type& s, const Vector<Type, 4>& a) {
     return Vector<Type, 4>{a[0] + s,
                            a[1] + s,
                            a[2] + s,
@@ -169,7 +164,7 @@ inline Vector<Type, 4> operator + (const Type& s, const Vector<Type, 4>& a) {
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator - (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
+constexpr Vector<Type, 4> operator - (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
     return Vector<Type, 4>{a[0] - b[0],
                            a[1] - b[1],
                            a[2] - b[2],
@@ -177,7 +172,7 @@ inline Vector<Type, 4> operator - (const Vector<Type, 4>& a, const Vector<Type,
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator - (const Vector<Type, 4>& a, const Type& s) {
+constexpr Vector<Type, 4> operator - (const Vector<Type, 4>& a, const Type& s) {
     return Vector<Type, 4>{a[0] - s,
                            a[1] - s,
                            a[2] - s,
@@ -185,7 +180,7 @@ inline Vector<Type, 4> operator - (const Vector<Type, 4>& a, const Type& s) {
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator - (const Vector<Type, 4>& a) {
+constexpr Vector<Type, 4> operator - (const Vector<Type, 4>& a) {
     return Vector<Type, 4>{-a[0],
                            -a[1],
                            -a[2],
@@ -193,7 +188,7 @@ inline Vector<Type, 4> operator - (const Vector<Type, 4>& a) {
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator * (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
+constexpr Vector<Type, 4> operator * (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
     return Vector<Type, 4>{a[0] * b[0],
                            a[1] * b[1],
                            a[2] * b[2],
@@ -201,7 +196,7 @@ inline Vector<Type, 4> operator * (const Vector<Type, 4>& a, const Vector<Type,
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator * (const Vector<Type, 4>& a, const Type& s) {
+constexpr Vector<Type, 4> operator * (const Vector<Type, 4>& a, const Type& s) {
     return Vector<Type, 4>{a[0] * s,
                            a[1] * s,
                            a[2] * s,
@@ -209,7 +204,7 @@ inline Vector<Type, 4> operator * (const Vector<Type, 4>& a, const Type& s) {
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator * (const Type& s, const Vector<Type, 4>& a) {
+constexpr Vector<Type, 4> operator * (const Type& s, const Vector<Type, 4>& a) {
     return Vector<Type, 4>{a[0] * s,
                            a[1] * s,
                            a[2] * s,
@@ -217,7 +212,7 @@ inline Vector<Type, 4> operator * (const Type& s, const Vector<Type, 4>& a) {
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator / (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
+constexpr Vector<Type, 4> operator / (const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
     return Vector<Type, 4>{a[0] / b[0],
                            a[1] / b[1],
                            a[2] / b[2],
@@ -225,7 +220,7 @@ inline Vector<Type, 4> operator / (const Vector<Type, 4>& a, const Vector<Type,
 }
 
 template<typename Type>
-inline Vector<Type, 4> operator / (const Vector<Type, 4>& a, const Type& s) {
+constexpr Vector<Type, 4> operator / (const Vector<Type, 4>& a, const Type& s) {
     return Vector<Type, 4>{a[0] / s,
                            a[1] / s,
                            a[2] / s,
@@ -233,7 +228,7 @@ inline Vector<Type, 4> operator / (const Vector<Type, 4>& a, const Type& s) {
 }
 
 template<typename Type>
-Type dot(const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
+constexpr Type dot(const Vector<Type, 4>& a, const Vector<Type, 4>& b) {
     return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
 }
 
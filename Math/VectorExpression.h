@@ -0,0 +1,197 @@
+//
+//  VectorExpression.h
+//  LD29
+//
+//  Copyright (c) 2014 Kristof Niederholtmeyer. All rights reserved.
+//
+
+#ifndef __game__VectorExpression__
+#define __game__VectorExpression__
+
+#include "Vector.h"
+
+/*
+ * Lazily evaluated vector arithmetic.
+ *
+ * lazy(v) wraps a vector. Combining wrapped operands with + - * / builds an
+ * expression instead of a temporary vector; the whole expression is evaluated
+ * in a single loop once it is converted to a Vector:
+ *
+ *     Vector3 p = lazy(position) + lazy(velocity) * dt * 5.0f;
+ *
+ * Each element goes through the same operations as with the eager operators,
+ * so the results are identical. Expressions only reference their operands,
+ * so they have to be evaluated before the end of the full expression (do not
+ * store them in auto variables).
+ */
+/*
+ * Assigns the first I elements of an expression, unrolled at compile time.
+ * A plain loop is left rolled by some compilers for small odd N.
+ */
+template<int I>
+struct VectorAssign {
+    template<typename V, typename E>
+    static void apply(V& result, const E& e) {
+        VectorAssign<I - 1>::apply(result, e);
+        result[I - 1] = e[I - 1];
+    }
+};
+
+template<>
+struct VectorAssign<0> {
+    template<typename V, typename E>
+    static void apply(V&, const E&) {}
+};
+
+template<typename Type, int N, typename E>
+struct VectorExpression {
+    const E& self() const {
+        return static_cast<const E&>(*this);
+    }
+
+    /*
+     * Evaluate the i´th element of the expression.
+     */
+    Type operator[] (int i) const {
+        return self()[i];
+    }
+
+    /*
+     * Evaluate the whole expression.
+     */
+    operator Vector<Type, N> () const {
+        Vector<Type, N> result;
+        VectorAssign<N>::apply(result, self());
+        return result;
+    }
+};
+
+/*
+ * A vector operand.
+ */
+template<typename Type, int N>
+struct VectorOperand : public VectorExpression<Type, N, VectorOperand<Type, N> > {
+    const Vector<Type, N>& v;
+
+    explicit VectorOperand(const Vector<Type, N>& v) : v(v) {}
+
+    Type operator[] (int i) const {
+        return v[i];
+    }
+};
+
+/*
+ * A scalar operand, the same value for every element.
+ */
+template<typename Type, int N>
+struct ScalarOperand : public VectorExpression<Type, N, ScalarOperand<Type, N> > {
+    Type s;
+
+    explicit ScalarOperand(const Type& s) : s(s) {}
+
+    Type operator[] (int) const {
+        return s;
+    }
+};
+
+/*
+ * Componentwise combination of two expressions.
+ */
+template<typename Type, int N, typename L, typename R, typename Op>
+struct VectorBinary : public VectorExpression<Type, N, VectorBinary<Type, N, L, R, Op> > {
+    L l;
+    R r;
+
+    VectorBinary(const L& l, const R& r) : l(l), r(r) {}
+
+    Type operator[] (int i) const {
+        return Op::apply(l[i], r[i]);
+    }
+};
+
+/*
+ * Componentwise negation of an expression.
+ */
+template<typename Type, int N, typename E>
+struct VectorNegate : public VectorExpression<Type, N, VectorNegate<Type, N, E> > {
+    E e;
+
+    explicit VectorNegate(const E& e) : e(e) {}
+
+    Type operator[] (int i) const {
+        return -e[i];
+    }
+};
+
+struct VectorAdd {
+    template<typename Type>
+    static Type apply(const Type& a, const Type& b) { return a + b; }
+};
+
+struct VectorSubtract {
+    template<typename Type>
+    static Type apply(const Type& a, const Type& b) { return a - b; }
+};
+
+struct VectorMultiply {
+    template<typename Type>
+    static Type apply(const Type& a, const Type& b) { return a * b; }
+};
+
+struct VectorDivide {
+    template<typename Type>
+    static Type apply(const Type& a, const Type& b) { return a / b; }
+};
+
+/*
+ * Start a lazily evaluated expression.
+ */
+template<typename Type, int N>
+inline VectorOperand<Type, N> lazy(const Vector<Type, N>& v) {
+    return VectorOperand<Type, N>(v);
+}
+
+/*
+ * Evaluate an expression explicitly.
+ */
+template<typename Type, int N, typename E>
+inline Vector<Type, N> evaluate(const VectorExpression<Type, N, E>& e) {
+    return e;
+}
+
+// The operators for one operation: expression with expression, vector or scalar.
+#define VECTOR_EXPRESSION_OPERATOR(op, Op) \
+template<typename Type, int N, typename L, typename R> \
+inline VectorBinary<Type, N, L, R, Op> operator op (const VectorExpression<Type, N, L>& l, const VectorExpression<Type, N, R>& r) { \
+    return VectorBinary<Type, N, L, R, Op>(l.self(), r.self()); \
+} \
+template<typename Type, int N, typename L> \
+inline VectorBinary<Type, N, L, VectorOperand<Type, N>, Op> operator op (const VectorExpression<Type, N, L>& l, const Vector<Type, N>& r) { \
+    return VectorBinary<Type, N, L, VectorOperand<Type, N>, Op>(l.self(), VectorOperand<Type, N>(r)); \
+} \
+template<typename Type, int N, typename R> \
+inline VectorBinary<Type, N, VectorOperand<Type, N>, R, Op> operator op (const Vector<Type, N>& l, const VectorExpression<Type, N, R>& r) { \
+    return VectorBinary<Type, N, VectorOperand<Type, N>, R, Op>(VectorOperand<Type, N>(l), r.self()); \
+} \
+template<typename Type, int N, typename L> \
+inline VectorBinary<Type, N, L, ScalarOperand<Type, N>, Op> operator op (const VectorExpression<Type, N, L>& l, const Type& s) { \
+    return VectorBinary<Type, N, L, ScalarOperand<Type, N>, Op>(l.self(), ScalarOperand<Type, N>(s)); \
+} \
+template<typename Type, int N, typename R> \
+inline VectorBinary<Type, N, ScalarOperand<Type, N>, R, Op> operator op (const Type& s, const VectorExpression<Type, N, R>& r) { \
+    return VectorBinary<Type, N, ScalarOperand<Type, N>, R, Op>(ScalarOperand<Type, N>(s), r.self()); \
+}
+
+VECTOR_EXPRESSION_OPERATOR(+, VectorAdd)
+VECTOR_EXPRESSION_OPERATOR(-, VectorSubtract)
+VECTOR_EXPRESSION_OPERATOR(*, VectorMultiply)
+VECTOR_EXPRESSION_OPERATOR(/, VectorDivide)
+
+#undef VECTOR_EXPRESSION_OPERATOR
+
+template<typename Type, int N, typename E>
+inline VectorNegate<Type, N, E> operator - (const VectorExpression<Type, N, E>& e) {
+    return VectorNegate<Type, N, E>(e.self());
+}
+
+#endif /* defined(__game__VectorExpression__) */